@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Number of global operator new calls so far on the calling thread. Only
+// available when the build enables DICE_ALLOC_HOOK, which replaces the
+// global allocator.
+uint64_t allocationCount();
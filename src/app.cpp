@@ -0,0 +1,257 @@
+#include "app.h"
+
+#include <algorithm>
+#include "utf8.h"
+
+static bool pointInRect(float x, float y, float rx, float ry, float rw, float rh) {
+    return x >= rx && x < rx + rw && y >= ry && y < ry + rh;
+}
+
+bool AppState::overButton() const {
+    return pointInRect(mouseX, mouseY, buttonX, buttonY, buttonWidth, buttonHeight);
+}
+
+int AppState::valueAt(float x, float y) const {
+    if (usesScrubber()) {
+        if (!pointInRect(x, y, diceStartX, diceY, diceAreaWidth, scrubberHeight)) {
+            return 0;
+        }
+        // The scrubber always spans the open window, zooming in as it shrinks.
+        int width = session.upperBound - session.lowerBound + 1;
+        int offset = static_cast<int>((x - diceStartX) * width / diceAreaWidth);
+        return session.lowerBound + std::min(offset, width - 1);
+    }
+    int startX = diceRowStartX();
+    if (x < startX || y < diceY || y >= diceY + diceFaceHeight) {
+        return 0;
+    }
+    int index = static_cast<int>((x - startX) / diceFaceSize);
+    return index < session.maxNumber ? index + 1 : 0;
+}
+
+int AppState::focusedScoreId() const {
+    const std::vector<Player>& players = session.players;
+    if (players.empty() || leaderboard == nullptr) {
+        return -1;
+    }
+    return leaderboard->findId(players[std::min(session.currentPlayer, static_cast<int>(players.size()) - 1)].name);
+}
+
+static void logGuess(AppState& app, const Player& player, int lower, int upper, GuessResult result) {
+    GuessEvent event = makeGuessEvent(player.name, player.bot);
+    event.thinkMs = static_cast<uint32_t>(std::min<uint64_t>(event.timeMs - std::min(app.thinkStartMs, event.timeMs), UINT32_MAX));
+    event.maxNumber = app.session.maxNumber;
+    event.lowerBound = lower;
+    event.upperBound = upper;
+    event.guess = app.selectedValue;
+    event.tries = player.tries;
+    event.result = static_cast<uint8_t>(result);
+    app.events->append(event);
+    app.thinkStartMs = event.timeMs;
+}
+
+void resetGame(AppState& app) {
+    GameSession& session = app.session;
+    session.reset();
+    session.beginTurn(app.rng->uniform(1, session.maxNumber));
+    app.message = "Vez de " + session.players[session.currentPlayer].name + ". Adivinhe o número (1-" + std::to_string(session.maxNumber) + "):";
+    app.hint = "";
+    app.currentState = "game";
+    app.botWait = 0;
+    app.thinkStartMs = eventClockMs();
+}
+
+void updateApp(AppState& app, const FrameInput& input) {
+    GameSession& session = app.session;
+    std::vector<Player>& players = session.players;
+    int& currentPlayer = session.currentPlayer;
+    int& maxNumber = session.maxNumber;
+    Leaderboard& leaderboard = *app.leaderboard;
+    app.mouseX = input.mouseX;
+    app.mouseY = input.mouseY;
+
+    for (int step = 0; step < app.animationSteps; step++) {
+        app.titleScale += app.titleScaleDirection;
+        if (app.titleScale > 1.05f || app.titleScale < 0.95f) {
+            app.titleScaleDirection *= -1;
+        }
+
+        app.messageOpacity += app.messageOpacityDirection;
+        if (app.messageOpacity < 0.7f || app.messageOpacity > 1.0f) {
+            app.messageOpacityDirection *= -1;
+        }
+    }
+
+    if (app.currentState == "game") {
+        if (players[currentPlayer].bot) {
+            if (++app.botWait >= AppState::botDelayFrames) {
+                app.botWait = 0;
+                app.selectedValue = app.strategy.bestGuess(session.lowerBound, session.upperBound);
+                app.guessMade = true;
+            }
+        } else if (input.mousePressed) {
+            int value = app.valueAt(input.mouseX, input.mouseY);
+            if (value > 0) {
+                app.selectedValue = value;
+                app.guessMade = true;
+            }
+        } else if (input.pressed(KeyEnter) && !app.inputText.empty()) {
+            int value = std::stoi(app.inputText);
+            app.inputText = "";
+            if (session.inWindow(value)) {
+                app.selectedValue = value;
+                app.guessMade = true;
+            }
+        }
+        // Handle guess
+        if (app.guessMade) {
+            const Player& guesser = players[currentPlayer];
+            int lower = session.lowerBound;
+            int upper = session.upperBound;
+            GuessResult result = session.guess(app.selectedValue);
+            app.guesses++;
+            if (app.events != nullptr) {
+                logGuess(app, guesser, lower, upper, result);
+            }
+            if (result == GuessResult::GameOver) {
+                app.guessCorrect = true;
+                app.currentState = "end";
+                GameOutcome outcome = session.outcome();
+                if (outcome.winners > 1) {
+                    app.message = "Empate! Múltiplos jogadores com " + std::to_string(outcome.minTries) + " tentativas!";
+                } else {
+                    app.message = players[outcome.winner].name + " venceu com " + std::to_string(outcome.minTries) + " tentativas!";
+                }
+                for (auto& player : players) {
+                    if (player.bot) {
+                        continue;
+                    }
+                    player.bestScore = leaderboard.recordGame(player.name, player.tries);
+                    if (app.scores != nullptr) {
+                        app.scores->recordGame(player.name, player.tries);
+                    }
+                }
+            } else if (result == GuessResult::Correct) {
+                app.guessCorrect = true;
+                session.beginTurn(app.rng->uniform(1, maxNumber));
+                app.message = "Vez de " + players[currentPlayer].name + ". Adivinhe o número (1-" + std::to_string(maxNumber) + "):";
+                app.hint = "";
+            } else {
+                app.guessCorrect = false;
+                if (result == GuessResult::Higher) {
+                    app.hint = "Tente um número maior!";
+                    app.lastHint = "maior";
+                } else {
+                    app.hint = "Tente um número menor!";
+                    app.lastHint = "menor";
+                }
+                app.showHint = true;
+                app.guessMade = false;
+            }
+            if (app.guessCorrect) {
+                app.selectedValue = 0;
+                app.guessMade = false;
+                app.showHint = false;
+            }
+        }
+    }
+
+    if (input.pressed(KeyEnter)) {
+        if (app.currentState == "setup" && !app.inputText.empty()) {
+            int numPlayers = std::max(1, std::min(std::stoi(app.inputText), AppState::maxPlayers));
+            for (int i = 0; i < numPlayers; i++) {
+                players.push_back({"Jogador " + std::to_string(i + 1), 0, 0});
+            }
+            app.currentState = "range";
+            app.message = "Maior número (2-" + std::to_string(AppState::maxRange) + ", ENTER = " + std::to_string(maxNumber) + "):";
+            app.inputText = "";
+        }
+        else if (app.currentState == "range") {
+            if (!app.inputText.empty()) {
+                maxNumber = std::max(2, std::min(std::stoi(app.inputText), AppState::maxRange));
+            }
+            app.strategy.build(maxNumber);
+            app.currentState = "name_input";
+            app.message = "Digite o nome para " + players[currentPlayer].name + " (ou bot):";
+            app.inputText = "";
+        }
+        else if (app.currentState == "name_input") {
+            if (!app.inputText.empty()) {
+                if (app.inputText == "bot") {
+                    players[currentPlayer].name = "Bot " + std::to_string(currentPlayer + 1);
+                    players[currentPlayer].bot = true;
+                } else {
+                    players[currentPlayer].name = app.inputText;
+                }
+                int id = leaderboard.findId(players[currentPlayer].name);
+                if (id >= 0) {
+                    players[currentPlayer].bestScore = leaderboard.entry(id).bestScore;
+                }
+                currentPlayer++;
+                if (currentPlayer >= static_cast<int>(players.size())) {
+                    app.currentState = "game";
+                    currentPlayer = 0;
+                    session.beginTurn(app.rng->uniform(1, maxNumber));
+                    app.message = "Vez de " + players[currentPlayer].name + ". Adivinhe o número (1-" + std::to_string(maxNumber) + "):";
+                    app.hint = "";
+                    app.thinkStartMs = eventClockMs();
+                } else {
+                    app.message = "Digite o nome para " + players[currentPlayer].name + " (ou bot):";
+                }
+                app.inputText = "";
+            }
+        }
+    }
+
+    if (input.pressed(KeyTab)) {
+        app.showScoreboard = !app.showScoreboard;
+    }
+
+    if (app.showScoreboard) {
+        const int visibleRows = AppState::visibleRows;
+        int& scrollTop = app.scrollTop;
+        int maxTop = std::max(0, static_cast<int>(leaderboard.size()) - visibleRows);
+        if (input.pressed(KeyDown)) scrollTop++;
+        if (input.pressed(KeyUp)) scrollTop--;
+        if (input.pressed(KeyPageDown)) scrollTop += visibleRows;
+        if (input.pressed(KeyPageUp)) scrollTop -= visibleRows;
+        if (input.pressed(KeyHome)) scrollTop = 0;
+        scrollTop -= input.wheel * 3;
+        if (input.pressed(KeyLeft) || input.pressed(KeyRight)) {
+            app.rankOrder = app.rankOrder == RankOrder::BestScore ? RankOrder::GamesPlayed : RankOrder::BestScore;
+            scrollTop = 0;
+        }
+        if (input.pressed(KeyEnd)) {
+            int me = app.focusedScoreId();
+            if (me >= 0) {
+                scrollTop = static_cast<int>(leaderboard.rankOf(me, app.rankOrder)) - visibleRows / 2;
+            }
+        }
+        scrollTop = std::max(0, std::min(scrollTop, maxTop));
+    }
+
+    for (int c = 0; c < input.charCount; c++) {
+        int key = input.chars[c];
+        if (app.currentState == "setup" || app.currentState == "game" || app.currentState == "range") {
+            if ((key >= 48) && (key <= 57) && app.inputText.length() < 7) {
+                app.inputText += (char)key;
+            }
+        } else if (key >= 32 && (key < 127 || key >= 160) && utf8Count(app.inputText.c_str()) < AppState::maxNameCodepoints) {
+            // Names are stored in fixed-size scoreboard records, so the
+            // byte length is capped as well as the codepoint count.
+            char encoded[4];
+            int bytes = utf8Encode(key, encoded);
+            if (bytes > 0 && app.inputText.size() + bytes <= ScoreStore::maxNameLength) {
+                app.inputText.append(encoded, bytes);
+            }
+        }
+    }
+
+    if (input.pressed(KeyBackspace)) {
+        utf8PopBack(app.inputText);
+    }
+
+    if (app.currentState == "end" && app.overButton() && input.mousePressed) {
+        resetGame(app);
+    }
+}
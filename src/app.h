@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "event_log.h"
+#include "game.h"
+#include "leaderboard.h"
+#include "rng.h"
+#include "score_writer.h"
+#include "strategy.h"
+
+enum InputKey : uint16_t {
+    KeyEnter = 1 << 0,
+    KeyTab = 1 << 1,
+    KeyBackspace = 1 << 2,
+    KeyUp = 1 << 3,
+    KeyDown = 1 << 4,
+    KeyPageUp = 1 << 5,
+    KeyPageDown = 1 << 6,
+    KeyHome = 1 << 7,
+    KeyEnd = 1 << 8,
+    KeyLeft = 1 << 9,
+    KeyRight = 1 << 10,
+    KeyF3 = 1 << 11,
+    KeyF4 = 1 << 12
+};
+
+// Everything the game reads from the user in one frame, independent of
+// raylib so it can be recorded, replayed and scripted.
+struct FrameInput {
+    static constexpr int maxChars = 16;
+
+    float mouseX = 0.0f;
+    float mouseY = 0.0f;
+    bool mousePressed = false;
+    uint16_t keys = 0;
+    int wheel = 0;
+    int charCount = 0;
+    int chars[maxChars] = {};
+
+    bool pressed(InputKey key) const { return (keys & key) != 0; }
+    bool any() const { return mousePressed || keys != 0 || wheel != 0 || charCount > 0; }
+};
+
+// Game state and screen layout advanced once per frame by updateApp().
+// The window build draws from it; replays and benchmarks run it headless.
+struct AppState {
+    static constexpr int screenWidth = 800;
+    static constexpr int screenHeight = 600;
+    // Faces on the dice sheet. Ranges up to this many values are played
+    // with one die per value; larger ones with the range scrubber.
+    static constexpr int diceSheetFaces = 6;
+    static constexpr int diceAreaWidth = 600;
+    static constexpr int diceFaceSize = diceAreaWidth / diceSheetFaces;
+    static constexpr int diceStartX = (screenWidth - diceAreaWidth) / 2;
+    static constexpr int diceY = 450;
+    static constexpr int scrubberHeight = 60;
+    static constexpr int maxRange = 1000000;
+    static constexpr int botDelayFrames = 45;
+    static constexpr int buttonWidth = 200;
+    static constexpr int buttonHeight = 50;
+    static constexpr int buttonX = (screenWidth - buttonWidth) / 2;
+    static constexpr int buttonY = 400;
+    static constexpr int visibleRows = 10;
+    static constexpr size_t maxNameCodepoints = 20;
+    // As many rows as the player box has room for.
+    static constexpr int maxPlayers = 6;
+
+    // The scoreboard as this process knows it; the file itself belongs to
+    // the score writer's thread.
+    Leaderboard* leaderboard = nullptr;
+    Rng* rng = nullptr;
+    // Optional; finished games are persisted when set.
+    ScoreWriter* scores = nullptr;
+    // Optional; every guess is appended when set.
+    EventLogWriter* events = nullptr;
+
+    GameSession session;
+    std::string inputText = "";
+    std::string message = "Digite o número de jogadores:";
+    std::string currentState = "setup";
+    std::string hint = "";
+    bool showScoreboard = false;
+
+    float titleScale = 1.0f;
+    float titleScaleDirection = 0.002f;
+    float messageOpacity = 1.0f;
+    float messageOpacityDirection = -0.01f;
+    // Animation steps per update, raised while the window runs at a lower
+    // frame rate so the title and message keep their speed.
+    int animationSteps = 1;
+
+    StrategyTable strategy;
+    int botWait = 0;
+    // Guesses taken so far, by people and bots alike.
+    uint64_t guesses = 0;
+    // When the current player's clock started: turn start or their last guess.
+    uint64_t thinkStartMs = 0;
+
+    int diceFaceHeight = diceFaceSize;
+    int selectedValue = 0;
+    bool guessMade = false;
+    bool guessCorrect = false;
+    bool showHint = false;
+    std::string lastHint = "";
+
+    RankOrder rankOrder = RankOrder::BestScore;
+    int scrollTop = 0;
+
+    float mouseX = 0.0f;
+    float mouseY = 0.0f;
+
+    bool overButton() const;
+    // A bot is thinking; the frame keeps changing without any input.
+    bool botTurn() const { return currentState == "game" && !session.players.empty() && session.players[session.currentPlayer].bot; }
+    bool usesScrubber() const { return session.maxNumber > diceSheetFaces; }
+    // Dice row for small ranges, centred like the six-face layout.
+    int diceRowStartX() const { return (screenWidth - session.maxNumber * diceFaceSize) / 2; }
+    // Value under the point on the dice row or scrubber, or 0.
+    int valueAt(float x, float y) const;
+    // Scoreboard id of the player whose rank the overlay follows, or -1.
+    int focusedScoreId() const;
+};
+
+void resetGame(AppState& app);
+void updateApp(AppState& app, const FrameInput& input);
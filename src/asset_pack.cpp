@@ -0,0 +1,130 @@
+#include "asset_pack.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct PackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+};
+
+static const char packMagic[8] = {'D', 'I', 'C', 'E', 'P', 'A', 'K', '1'};
+static const uint32_t packVersion = 1;
+static const size_t packAlignment = 64;
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(PackHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    base = static_cast<unsigned char*>(mapped);
+    length = static_cast<size_t>(info.st_size);
+
+    const PackHeader* header = reinterpret_cast<const PackHeader*>(base);
+    if (std::memcmp(header->magic, packMagic, sizeof(packMagic)) != 0 || header->version != packVersion ||
+        sizeof(PackHeader) + header->entryCount * sizeof(PackEntry) > length) {
+        close();
+        return false;
+    }
+    entryCount = header->entryCount;
+    entries = reinterpret_cast<const PackEntry*>(base + sizeof(PackHeader));
+    for (uint32_t i = 0; i < entryCount; i++) {
+        if (entries[i].offset > length || entries[i].size > length - entries[i].offset) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPack::close() {
+    if (base != nullptr) {
+        ::munmap(base, length);
+    }
+    base = nullptr;
+    length = 0;
+    entries = nullptr;
+    entryCount = 0;
+}
+
+const PackEntry* AssetPack::find(const char* name) const {
+    for (uint32_t i = 0; i < entryCount; i++) {
+        if (std::strncmp(entries[i].name, name, sizeof(entries[i].name)) == 0) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+void AssetPack::prefetch() const {
+    if (base != nullptr) {
+        ::madvise(base, length, MADV_WILLNEED);
+    }
+}
+
+void AssetPackWriter::add(const char* name, AssetType type, uint32_t width, uint32_t height, uint32_t format,
+                          const void* data, size_t size) {
+    PackEntry entry = {};
+    std::snprintf(entry.name, sizeof(entry.name), "%s", name);
+    entry.type = type;
+    entry.width = width;
+    entry.height = height;
+    entry.format = format;
+    entry.offset = payload.size();
+    entry.size = size;
+    entries.push_back(entry);
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    payload.insert(payload.end(), bytes, bytes + size);
+    payload.resize((payload.size() + packAlignment - 1) / packAlignment * packAlignment, 0);
+}
+
+bool AssetPackWriter::write(const std::string& path) const {
+    PackHeader header = {};
+    std::memcpy(header.magic, packMagic, sizeof(packMagic));
+    header.version = packVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+
+    size_t tableEnd = sizeof(PackHeader) + entries.size() * sizeof(PackEntry);
+    size_t dataStart = (tableEnd + packAlignment - 1) / packAlignment * packAlignment;
+    std::vector<PackEntry> table = entries;
+    for (auto& entry : table) {
+        entry.offset += dataStart;
+    }
+
+    std::string temp = path + ".tmp";
+    FILE* file = std::fopen(temp.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    static const unsigned char padding[packAlignment] = {};
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        (table.empty() || std::fwrite(table.data(), sizeof(PackEntry), table.size(), file) == table.size()) &&
+        std::fwrite(padding, 1, dataStart - tableEnd, file) == dataStart - tableEnd &&
+        (payload.empty() || std::fwrite(payload.data(), 1, payload.size(), file) == payload.size());
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
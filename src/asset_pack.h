@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class AssetType : uint32_t {
+    Image = 1,
+    Blob = 2,
+    Glyphs = 3
+};
+
+struct PackEntry {
+    char name[48];
+    AssetType type;
+    // Image: pixel size and raylib PixelFormat. Glyphs: base font size in
+    // `width`, glyph count in `height`.
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Layout of one glyph in a pre-baked font atlas.
+struct PackGlyph {
+    int32_t value;
+    int32_t offsetX;
+    int32_t offsetY;
+    int32_t advanceX;
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+// Read-only view of a packed asset file, memory-mapped so pixel data is
+// handed to the GPU straight from the page cache.
+class AssetPack {
+public:
+    AssetPack() = default;
+    ~AssetPack();
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    const PackEntry* find(const char* name) const;
+    const unsigned char* data(const PackEntry& entry) const { return base + entry.offset; }
+    // Asks the kernel to read the whole file ahead so first use does not
+    // fault pages in one by one.
+    void prefetch() const;
+
+private:
+    unsigned char* base = nullptr;
+    size_t length = 0;
+    const PackEntry* entries = nullptr;
+    uint32_t entryCount = 0;
+};
+
+class AssetPackWriter {
+public:
+    void add(const char* name, AssetType type, uint32_t width, uint32_t height, uint32_t format,
+             const void* data, size_t size);
+    bool write(const std::string& path) const;
+
+private:
+    std::vector<PackEntry> entries;
+    std::vector<unsigned char> payload;
+};
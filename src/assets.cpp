@@ -0,0 +1,124 @@
+#include "assets.h"
+
+#include <cstdlib>
+#include <cstring>
+
+static const int fontBakeSize = 32;
+// Larger than any texture the GPU would take; keeps the size math in int.
+static const uint32_t maxImageSide = 16384;
+
+bool bakeFontAtlas(const char* fontPath, int fontSize, Image& atlas, std::vector<PackGlyph>& glyphs) {
+    if (!FileExists(fontPath)) {
+        return false;
+    }
+    unsigned int fileSize = 0;
+    unsigned char* fileData = LoadFileData(fontPath, &fileSize);
+    if (fileData == nullptr) {
+        return false;
+    }
+    const int glyphCount = 95;
+    GlyphInfo* info = LoadFontData(fileData, static_cast<int>(fileSize), fontSize, nullptr, glyphCount, FONT_DEFAULT);
+    UnloadFileData(fileData);
+    if (info == nullptr) {
+        return false;
+    }
+    Rectangle* recs = nullptr;
+    atlas = GenImageFontAtlas(info, &recs, glyphCount, fontSize, fontGlyphPadding, 0);
+    glyphs.clear();
+    for (int i = 0; i < glyphCount; i++) {
+        glyphs.push_back({info[i].value, info[i].offsetX, info[i].offsetY, info[i].advanceX,
+            recs[i].x, recs[i].y, recs[i].width, recs[i].height});
+    }
+    UnloadFontData(info, glyphCount);
+    std::free(recs);
+    return atlas.data != nullptr;
+}
+
+// The pack only guarantees an entry lies inside the file; an image whose
+// size disagrees with its pixel format is refused rather than uploaded.
+static bool packedImage(const AssetPack& pack, const PackEntry& entry, Image& image) {
+    if (entry.width == 0 || entry.height == 0 || entry.width > maxImageSide || entry.height > maxImageSide ||
+        entry.size == 0 || entry.size != static_cast<uint64_t>(GetPixelDataSize(static_cast<int>(entry.width),
+            static_cast<int>(entry.height), static_cast<int>(entry.format)))) {
+        TraceLog(LOG_WARNING, "Assets: entrada %.*s com tamanho invalido", static_cast<int>(sizeof(entry.name)), entry.name);
+        return false;
+    }
+    image = {};
+    image.data = const_cast<unsigned char*>(pack.data(entry));
+    image.width = static_cast<int>(entry.width);
+    image.height = static_cast<int>(entry.height);
+    image.mipmaps = 1;
+    image.format = static_cast<int>(entry.format);
+    return true;
+}
+
+void loadGameAssets(AssetPack& pack, const char* packPath, GameAssets& assets) {
+    if (pack.open(packPath)) {
+        pack.prefetch();
+        assets.fromPack = true;
+        if (const PackEntry* entry = pack.find("dice")) {
+            packedImage(pack, *entry, assets.dice);
+        }
+        if (const PackEntry* entry = pack.find("music.mp3")) {
+            assets.music = pack.data(*entry);
+            assets.musicSize = static_cast<int>(entry->size);
+        }
+        const PackEntry* atlas = pack.find("font.atlas");
+        const PackEntry* glyphs = pack.find("font.glyphs");
+        bool glyphsFit = glyphs != nullptr && glyphs->size == static_cast<uint64_t>(glyphs->height) * sizeof(PackGlyph);
+        if (glyphs != nullptr && !glyphsFit) {
+            TraceLog(LOG_WARNING, "Assets: entrada %.*s com tamanho invalido", static_cast<int>(sizeof(glyphs->name)), glyphs->name);
+        }
+        if (atlas != nullptr && glyphsFit && packedImage(pack, *atlas, assets.fontAtlas)) {
+            const PackGlyph* first = reinterpret_cast<const PackGlyph*>(pack.data(*glyphs));
+            assets.glyphs.assign(first, first + glyphs->height);
+            assets.fontBaseSize = static_cast<int>(glyphs->width);
+        }
+        if (const PackEntry* entry = pack.find("font.ttf")) {
+            assets.fontFile = pack.data(*entry);
+            assets.fontFileSize = static_cast<int>(entry->size);
+        }
+    }
+
+    if (assets.dice.data == nullptr) {
+        assets.dice = LoadImage("resources/clipart1023082.png");
+        assets.diceOwned = true;
+    }
+    if (assets.music == nullptr) {
+        unsigned int size = 0;
+        assets.music = LoadFileData("resources/music.mp3", &size);
+        assets.musicSize = static_cast<int>(size);
+        assets.musicOwned = assets.music != nullptr;
+    }
+    if (assets.fontAtlas.data == nullptr &&
+        bakeFontAtlas("resources/font.ttf", fontBakeSize, assets.fontAtlas, assets.glyphs)) {
+        assets.fontAtlasOwned = true;
+        assets.fontBaseSize = fontBakeSize;
+    }
+    if (assets.fontFile == nullptr && assets.fontAtlasOwned) {
+        unsigned int size = 0;
+        assets.fontFile = LoadFileData("resources/font.ttf", &size);
+        assets.fontFileSize = static_cast<int>(size);
+        assets.fontFileOwned = assets.fontFile != nullptr;
+    }
+}
+
+Texture2D uploadDiceTexture(const GameAssets& assets) {
+    return LoadTextureFromImage(assets.dice);
+}
+
+void releaseGameAssets(GameAssets& assets) {
+    if (assets.diceOwned) {
+        UnloadImage(assets.dice);
+    }
+    if (assets.musicOwned) {
+        UnloadFileData(const_cast<unsigned char*>(assets.music));
+    }
+    if (assets.fontAtlasOwned) {
+        UnloadImage(assets.fontAtlas);
+    }
+    if (assets.fontFileOwned) {
+        UnloadFileData(const_cast<unsigned char*>(assets.fontFile));
+    }
+    assets = GameAssets{};
+}
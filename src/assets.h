@@ -0,0 +1,38 @@
+#pragma once
+
+#include <raylib.h>
+#include <vector>
+#include "asset_pack.h"
+
+const int fontGlyphPadding = 4;
+
+// CPU-side assets prepared off the render thread. Pixel and music data
+// either point into the mapped pack or are owned decodes of the loose
+// files in resources/ when no pack is present.
+struct GameAssets {
+    Image dice = {};
+    bool diceOwned = false;
+    const unsigned char* music = nullptr;
+    int musicSize = 0;
+    bool musicOwned = false;
+    Image fontAtlas = {};
+    bool fontAtlasOwned = false;
+    std::vector<PackGlyph> glyphs;
+    int fontBaseSize = 0;
+    // The TTF itself, for glyphs outside the baked ASCII set.
+    const unsigned char* fontFile = nullptr;
+    int fontFileSize = 0;
+    bool fontFileOwned = false;
+    bool fromPack = false;
+};
+
+// Safe to call from a worker thread: no GL or audio calls.
+void loadGameAssets(AssetPack& pack, const char* packPath, GameAssets& assets);
+
+// Render thread only.
+Texture2D uploadDiceTexture(const GameAssets& assets);
+void releaseGameAssets(GameAssets& assets);
+
+// Bakes an ASCII atlas from a TTF file on the CPU; used by both the
+// packer and the loose-file fallback.
+bool bakeFontAtlas(const char* fontPath, int fontSize, Image& atlas, std::vector<PackGlyph>& glyphs);
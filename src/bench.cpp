@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "app.h"
+#include "game.h"
+#include "leaderboard.h"
+#include "rng.h"
+#include "score_store.h"
+#include "strategy.h"
+#include "text_cache.h"
+
+struct BenchOptions {
+    const char* filter = nullptr;
+    const char* output = nullptr;
+    size_t maxEntries = 1000000;
+    int repeats = 5;
+    uint64_t seed = 12345;
+};
+
+static BenchOptions options;
+static FILE* out = stdout;
+
+static double nowMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Runs `body` `repeats` times after `setup`; each run performs `ops`
+// operations. Reports the median run as one JSON line.
+static void bench(const char* name, size_t size, size_t ops,
+                  const std::function<void()>& setup, const std::function<void()>& body) {
+    if (options.filter != nullptr && std::strstr(name, options.filter) == nullptr) {
+        return;
+    }
+    std::vector<double> runs;
+    for (int r = 0; r < options.repeats; r++) {
+        if (setup) {
+            setup();
+        }
+        double start = nowMs();
+        body();
+        runs.push_back(nowMs() - start);
+    }
+    std::sort(runs.begin(), runs.end());
+    double median = runs[runs.size() / 2];
+    std::fprintf(out,
+        "{\"name\":\"%s\",\"size\":%zu,\"ops\":%zu,\"repeats\":%d,\"median_ms\":%.4f,\"min_ms\":%.4f,\"ns_per_op\":%.2f}\n",
+        name, size, ops, options.repeats, median, runs.front(), median * 1e6 / static_cast<double>(ops));
+    std::fflush(out);
+}
+
+static std::string benchPath(const char* kind, size_t size) {
+    return "dice_bench_" + std::string(kind) + "_" + std::to_string(size) + "_" + std::to_string(::getpid());
+}
+
+static void writeSyntheticCsv(const std::string& path, size_t entries, Rng& rng) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        std::fprintf(stderr, "Nao foi possivel criar %s\n", path.c_str());
+        std::exit(1);
+    }
+    for (size_t i = 0; i < entries; i++) {
+        std::fprintf(file, "Jogador %zu,%d,%d\n", i, rng.uniform(1, 6), rng.uniform(1, 500));
+    }
+    std::fclose(file);
+}
+
+static void benchScoreboard(size_t entries) {
+    Rng rng(options.seed + entries);
+    std::string csv = benchPath("csv", entries);
+    std::string bin = benchPath("bin", entries);
+    writeSyntheticCsv(csv, entries, rng);
+
+    bench("scoreboard.import_csv", entries, entries,
+        [&]() { ::unlink(bin.c_str()); },
+        [&]() {
+            ScoreStore store;
+            store.open(bin);
+            importScoreboardCsv(csv, store);
+        });
+
+    bench("scoreboard.open", entries, 1, nullptr, [&]() {
+        ScoreStore store;
+        store.open(bin);
+    });
+
+    std::string exported = benchPath("export", entries);
+    bench("scoreboard.export_csv", entries, entries, nullptr, [&]() {
+        ScoreStore store;
+        store.open(bin);
+        exportScoreboardCsv(store, exported);
+    });
+
+    const size_t lookups = 100000;
+    std::vector<std::string> names;
+    for (size_t i = 0; i < lookups; i++) {
+        names.push_back("Jogador " + std::to_string(rng.uniform(0, static_cast<int>(entries) - 1)));
+    }
+    {
+        ScoreStore store;
+        store.open(bin);
+        bench("scoreboard.find", entries, lookups, nullptr, [&]() {
+            size_t found = 0;
+            for (const auto& name : names) {
+                found += store.find(name) != nullptr;
+            }
+            if (found != lookups) {
+                std::fprintf(stderr, "scoreboard.find: %zu de %zu\n", found, lookups);
+            }
+        });
+        bench("scoreboard.record_game", entries, lookups, nullptr, [&]() {
+            for (size_t i = 0; i < lookups; i++) {
+                store.recordGame(names[i], static_cast<int>(i % 6) + 1);
+            }
+        });
+
+        Leaderboard leaderboard;
+        bench("leaderboard.build", entries, entries, nullptr, [&]() { leaderboard.build(store); });
+        bench("leaderboard.rank_of", entries, lookups, nullptr, [&]() {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < lookups; i++) {
+                sum += leaderboard.rankOf(static_cast<uint32_t>(i % entries), RankOrder::BestScore);
+            }
+            if (sum == UINT64_MAX) {
+                std::fprintf(stderr, "%llu\n", static_cast<unsigned long long>(sum));
+            }
+        });
+        bench("leaderboard.update", entries, lookups, nullptr, [&]() {
+            for (size_t i = 0; i < lookups; i++) {
+                uint32_t id = static_cast<uint32_t>(i % entries);
+                ScoreEntry entry = leaderboard.entry(id);
+                entry.gamesPlayed++;
+                leaderboard.update(id, entry);
+            }
+        });
+    }
+
+    ::unlink(csv.c_str());
+    ::unlink(bin.c_str());
+    ::unlink(exported.c_str());
+}
+
+static void benchTurns() {
+    const size_t games = 1000000;
+    Rng rng(options.seed);
+    GameSession session;
+    session.players = {{"A", 0, 0}, {"B", 0, 0}, {"C", 0, 0}};
+    std::vector<int> targets(games * session.players.size());
+    rng.fillTargets(targets.data(), targets.size(), session.maxNumber);
+
+    size_t guesses = 0;
+    bench("game.play_binary", games, games, nullptr, [&]() {
+        size_t next = 0;
+        for (size_t g = 0; g < games; g++) {
+            session.reset();
+            session.beginTurn(targets[next++]);
+            while (!session.finished) {
+                guesses++;
+                GuessResult result = session.guess(session.lowerBound + (session.upperBound - session.lowerBound) / 2);
+                if (result == GuessResult::Correct) {
+                    session.beginTurn(targets[next++]);
+                }
+            }
+        }
+    });
+
+    const size_t draws = 10000000;
+    bench("rng.fill_targets", draws, draws, nullptr, [&]() {
+        std::vector<int> buffer(draws);
+        rng.fillTargets(buffer.data(), buffer.size(), 6);
+    });
+}
+
+static void benchStrategy() {
+    const int maxNumber = 1000000;
+    StrategyTable table;
+    bench("strategy.build", maxNumber, maxNumber, [&]() { table = StrategyTable(); }, [&]() {
+        table.build(maxNumber);
+    });
+
+    const size_t lookups = 10000000;
+    std::vector<int> bounds(lookups);
+    Rng rng(options.seed);
+    rng.fillTargets(bounds.data(), bounds.size(), maxNumber);
+    double sink = 0.0;
+    bench("strategy.lookup", lookups, lookups / 2, nullptr, [&]() {
+        for (size_t i = 0; i + 1 < lookups; i += 2) {
+            int lower = std::min(bounds[i], bounds[i + 1]);
+            int upper = std::max(bounds[i], bounds[i + 1]);
+            sink += table.expectedTries(lower, upper) + table.bestGuess(lower, upper);
+        }
+    });
+    if (sink < 0.0) {
+        std::fprintf(stderr, "%f\n", sink);
+    }
+}
+
+static void benchLabels() {
+    const size_t frames = 1000000;
+    std::vector<Player> players = {{"Pedro", 3, 1}, {"Afonso", 2, 2}, {"João", 0, 0}, {"Jogador 4", 5, 0}};
+    std::vector<TextLabel> labels(players.size());
+
+    auto refresh = [&]() {
+        for (size_t i = 0; i < players.size(); i++) {
+            const Player& player = players[i];
+            uint64_t key = labelKey(labelKey(labelKey(0, player.name.data(), player.name.size()),
+                static_cast<uint64_t>(player.bestScore)), static_cast<uint64_t>(player.tries));
+            if (labels[i].stale(key)) {
+                labels[i].format(key, "%s (Melhor: %d): %d tentativas", player.name.c_str(), player.bestScore, player.tries);
+                labels[i].setMeasured(25, 2, 0, 25);
+            }
+        }
+    };
+    bench("labels.steady_frame", frames, frames, nullptr, [&]() {
+        for (size_t f = 0; f < frames; f++) {
+            refresh();
+        }
+    });
+    bench("labels.changing_frame", frames, frames, nullptr, [&]() {
+        for (size_t f = 0; f < frames; f++) {
+            players[f % players.size()].tries++;
+            refresh();
+        }
+    });
+    bench("labels.string_concat_frame", frames, frames, nullptr, [&]() {
+        size_t total = 0;
+        for (size_t f = 0; f < frames; f++) {
+            for (const auto& player : players) {
+                std::string playerInfo = player.name;
+                if (player.bestScore > 0) {
+                    playerInfo += " (Melhor: " + std::to_string(player.bestScore) + ")";
+                }
+                playerInfo += ": " + std::to_string(player.tries) + " tentativas";
+                total += playerInfo.size();
+            }
+        }
+        if (total == 0) {
+            std::fprintf(stderr, "labels.string_concat_frame: vazio\n");
+        }
+    });
+}
+
+// Headless stand-in for the main loop: scripted clicks drive the session
+// while each frame refreshes player and visible scoreboard labels the way
+// the window build does.
+static void benchFrameLoop() {
+    const size_t frames = 200000;
+    const size_t entries = 10000;
+    const int framesPerClick = 4;
+    const int visibleRows = 10;
+    std::string bin = benchPath("frames", entries);
+    ::unlink(bin.c_str());
+    ScoreStore store;
+    store.open(bin);
+    for (size_t i = 0; i < entries; i++) {
+        store.put({"Jogador " + std::to_string(i), static_cast<int>(i % 6) + 1, static_cast<int>(i % 97) + 1});
+    }
+    Leaderboard leaderboard;
+    leaderboard.build(store);
+
+    Rng rng(options.seed);
+    AppState app;
+    app.leaderboard = &leaderboard;
+    app.rng = &rng;
+    GameSession& session = app.session;
+    session.players = {{"Pedro", 0, 0}, {"Afonso", 0, 0}};
+    std::vector<TextLabel> playerLabels(session.players.size());
+    std::vector<TextLabel> rowLabels(visibleRows);
+
+    // Scripted clicks go through updateApp() exactly like recorded input:
+    // the middle of the open window while playing, the button once over.
+    bench("frame_loop.scripted", frames, frames,
+        [&]() {
+            resetGame(app);
+        },
+        [&]() {
+            for (size_t f = 0; f < frames; f++) {
+                FrameInput input;
+                if (f % framesPerClick == 0) {
+                    input.mousePressed = true;
+                    if (app.currentState == "end") {
+                        input.mouseX = AppState::buttonX + AppState::buttonWidth / 2.0f;
+                        input.mouseY = AppState::buttonY + AppState::buttonHeight / 2.0f;
+                    } else {
+                        int die = (session.lowerBound + session.upperBound) / 2;
+                        input.mouseX = AppState::diceStartX + (die - 1) * AppState::diceFaceSize + AppState::diceFaceSize / 2.0f;
+                        input.mouseY = AppState::diceY + app.diceFaceHeight / 2.0f;
+                    }
+                }
+                updateApp(app, input);
+                for (size_t i = 0; i < session.players.size(); i++) {
+                    const Player& player = session.players[i];
+                    uint64_t key = labelKey(labelKey(labelKey(0, player.name.data(), player.name.size()),
+                        static_cast<uint64_t>(player.bestScore)), static_cast<uint64_t>(player.tries));
+                    if (playerLabels[i].stale(key)) {
+                        playerLabels[i].format(key, "%s (Melhor: %d): %d tentativas", player.name.c_str(), player.bestScore, player.tries);
+                    }
+                }
+                for (int row = 0; row < visibleRows; row++) {
+                    uint32_t id = leaderboard.at(static_cast<uint32_t>(row), RankOrder::BestScore);
+                    const ScoreEntry& entry = leaderboard.entry(id);
+                    uint64_t key = labelKey(labelKey(labelKey(0, id), static_cast<uint64_t>(entry.bestScore)),
+                        static_cast<uint64_t>(entry.gamesPlayed));
+                    if (rowLabels[row].stale(key)) {
+                        rowLabels[row].format(key, "%d. %s - Melhor: %d (Jogos: %d)", row + 1, entry.name.c_str(), entry.bestScore, entry.gamesPlayed);
+                    }
+                }
+            }
+        });
+    ::unlink(bin.c_str());
+}
+
+static void printUsage(const char* program) {
+    std::fprintf(stderr, "Uso: %s [--filter TEXTO] [--max-entries N] [--repeats N] [--seed N] [--out ARQUIVO]\n", program);
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (std::strcmp(argv[i], "--filter") == 0) {
+            options.filter = value;
+        } else if (std::strcmp(argv[i], "--max-entries") == 0) {
+            options.maxEntries = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--repeats") == 0) {
+            options.repeats = std::max(1, std::atoi(value));
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--out") == 0) {
+            options.output = value;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (options.output != nullptr) {
+        out = std::fopen(options.output, "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "Nao foi possivel escrever %s\n", options.output);
+            return 1;
+        }
+    }
+
+    for (size_t entries = 10; entries <= options.maxEntries; entries *= 10) {
+        benchScoreboard(entries);
+    }
+    benchTurns();
+    benchLabels();
+    benchStrategy();
+    benchFrameLoop();
+
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
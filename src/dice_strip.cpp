@@ -0,0 +1,53 @@
+#include "dice_strip.h"
+
+#include <cstddef>
+#include <rlgl.h>
+
+void DiceStrip::layout(const Texture2D& sheet, int sheetFaces, int faces, float startX, float y,
+                       float faceWidth, float faceHeight) {
+    Layout next = {sheet.id, sheetFaces, faces, startX, y, faceWidth, faceHeight};
+    if (next.texture == current.texture && next.sheetFaces == current.sheetFaces && next.faces == current.faces &&
+        next.startX == current.startX && next.y == current.y && next.faceWidth == current.faceWidth &&
+        next.faceHeight == current.faceHeight) {
+        return;
+    }
+    current = next;
+    quads.resize(static_cast<size_t>(faces));
+    float sheetFaceWidth = static_cast<float>(sheet.width / sheetFaces);
+    for (int i = 0; i < faces; i++) {
+        Quad& quad = quads[i];
+        quad.x0 = startX + i * faceWidth;
+        quad.y0 = y;
+        quad.x1 = quad.x0 + faceWidth;
+        quad.y1 = y + faceHeight;
+        float sheetX = (i % sheetFaces) * sheetFaceWidth;
+        quad.u0 = sheetX / sheet.width;
+        quad.v0 = 0.0f;
+        quad.u1 = (sheetX + sheetFaceWidth) / sheet.width;
+        quad.v1 = 1.0f;
+    }
+}
+
+void DiceStrip::draw(const Texture2D& sheet, const Color* tints) const {
+    if (quads.empty() || sheet.id == 0) {
+        return;
+    }
+    rlCheckRenderBatchLimit(4 * faces());
+    rlSetTexture(sheet.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (size_t i = 0; i < quads.size(); i++) {
+        const Quad& quad = quads[i];
+        rlColor4ub(tints[i].r, tints[i].g, tints[i].b, tints[i].a);
+        rlTexCoord2f(quad.u0, quad.v0);
+        rlVertex2f(quad.x0, quad.y0);
+        rlTexCoord2f(quad.u0, quad.v1);
+        rlVertex2f(quad.x0, quad.y1);
+        rlTexCoord2f(quad.u1, quad.v1);
+        rlVertex2f(quad.x1, quad.y1);
+        rlTexCoord2f(quad.u1, quad.v0);
+        rlVertex2f(quad.x1, quad.y0);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
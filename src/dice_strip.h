@@ -0,0 +1,34 @@
+#pragma once
+
+#include <raylib.h>
+#include <vector>
+
+// The dice row as one batch of textured quads from the dice sheet. Quad
+// corners and atlas coordinates are rebuilt only when the layout changes;
+// a frame just streams them to rlgl with the current tints, so the whole
+// strip goes out in a single draw call.
+class DiceStrip {
+public:
+    // Cheap when nothing changed: the arguments are compared to the last
+    // layout before anything is recomputed.
+    void layout(const Texture2D& sheet, int sheetFaces, int faces, float startX, float y,
+                float faceWidth, float faceHeight);
+    // `tints` holds one colour per face.
+    void draw(const Texture2D& sheet, const Color* tints) const;
+    int faces() const { return static_cast<int>(quads.size()); }
+
+private:
+    struct Quad {
+        float x0, y0, x1, y1;
+        float u0, v0, u1, v1;
+    };
+
+    struct Layout {
+        unsigned int texture;
+        int sheetFaces, faces;
+        float startX, y, faceWidth, faceHeight;
+    };
+
+    std::vector<Quad> quads;
+    Layout current = {};
+};
@@ -0,0 +1,455 @@
+#include "event_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char eventMagic[8] = {'D', 'I', 'C', 'E', 'E', 'V', 'T', '1'};
+static const uint32_t eventVersion = 1;
+static const size_t popBatch = 64;
+// Blocks are at most a few hundred KB; anything larger is a damaged header.
+static const uint32_t maxBlockBytes = 64u << 20;
+
+enum EventColumn {
+    ColumnTime,
+    ColumnPlayer,
+    ColumnFlags,
+    ColumnMaxNumber,
+    ColumnLowerBound,
+    ColumnWidth,
+    ColumnGuess,
+    ColumnTries,
+    ColumnThink,
+    ColumnCount
+};
+
+static const uint8_t flagBot = 1 << 2;
+static const uint8_t resultMask = 3;
+
+static uint32_t checksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Several kiosks may append to one log: every block is written at the end
+// of the file while holding an exclusive lock on it.
+static bool lockFile(FILE* file) {
+    while (::flock(::fileno(file), LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void unlockFile(FILE* file) {
+    ::flock(::fileno(file), LOCK_UN);
+}
+
+static uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+struct ByteCursor {
+    const uint8_t* at;
+    const uint8_t* end;
+    bool ok;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (at == end) {
+                break;
+            }
+            uint8_t byte = *at++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+};
+
+uint64_t eventClockMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+GuessEvent makeGuessEvent(const std::string& player, bool bot) {
+    GuessEvent event = {};
+    event.timeMs = eventClockMs();
+    event.bot = bot;
+    size_t length = std::min(player.size(), GuessEvent::maxNameLength);
+    std::memcpy(event.player, player.data(), length);
+    event.player[length] = '\0';
+    return event;
+}
+
+EventLogWriter::EventLogWriter(size_t ringCapacity) : ring(ringCapacity) {
+}
+
+EventLogWriter::~EventLogWriter() {
+    close();
+}
+
+bool EventLogWriter::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    file = ::fdopen(fd, "r+b");
+    if (file == nullptr) {
+        ::close(fd);
+        return false;
+    }
+    if (!lockFile(file) || !recover()) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    unlockFile(file);
+    pending.reserve(blockEvents);
+    running.store(true);
+    worker = std::thread(&EventLogWriter::writeLoop, this);
+    return true;
+}
+
+bool EventLogWriter::recover() {
+    struct stat info = {};
+    ::fstat(::fileno(file), &info);
+    uint64_t fileSize = static_cast<uint64_t>(info.st_size);
+    EventLogHeader header = {};
+    if (fileSize == 0) {
+        std::memcpy(header.magic, eventMagic, sizeof(eventMagic));
+        header.version = eventVersion;
+        header.blockEvents = blockEvents;
+        return std::fwrite(&header, sizeof(header), 1, file) == 1 && std::fflush(file) == 0;
+    }
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, eventMagic, sizeof(eventMagic)) != 0 || header.version != eventVersion) {
+        return false;
+    }
+    // Skip whole blocks and cut off a torn one left by a crash, so new
+    // blocks stay reachable. After a power loss a block can have its full
+    // size but a zeroed payload, so the checksum decides, not the size.
+    uint64_t offset = sizeof(header);
+    EventBlockHeader block = {};
+    while (offset + sizeof(block) <= fileSize && std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0 &&
+        std::fread(&block, sizeof(block), 1, file) == 1 && block.bytes <= maxBlockBytes &&
+        offset + sizeof(block) + block.bytes <= fileSize) {
+        encoded.resize(block.bytes);
+        if (std::fread(encoded.data(), 1, encoded.size(), file) != encoded.size() ||
+            checksum(encoded.data(), encoded.size()) != block.checksum) {
+            break;
+        }
+        offset += sizeof(block) + block.bytes;
+    }
+    encoded.clear();
+    if (offset < fileSize && ::ftruncate(::fileno(file), static_cast<off_t>(offset)) != 0) {
+        return false;
+    }
+    return true;
+}
+
+void EventLogWriter::close() {
+    if (file == nullptr) {
+        return;
+    }
+    running.store(false);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    std::fclose(file);
+    file = nullptr;
+}
+
+void EventLogWriter::append(const GuessEvent& event) {
+    if (file != nullptr && !tryAppend(event)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool EventLogWriter::tryAppend(const GuessEvent& event) {
+    return file != nullptr && ring.push(&event, 1) == 1;
+}
+
+EventLogStats EventLogWriter::stats() const {
+    return {events.load(std::memory_order_relaxed), dropped.load(std::memory_order_relaxed),
+        blocks.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed)};
+}
+
+void EventLogWriter::writeLoop() {
+    GuessEvent batch[popBatch];
+    auto lastWrite = std::chrono::steady_clock::now();
+    for (;;) {
+        // Read the flag before draining so nothing appended before close()
+        // is left in the ring.
+        bool stopping = !running.load();
+        size_t got;
+        bool drained = false;
+        while ((got = ring.pop(batch, popBatch)) > 0) {
+            drained = true;
+            for (size_t i = 0; i < got; i++) {
+                pending.push_back(batch[i]);
+                if (pending.size() == blockEvents) {
+                    writeBlock();
+                    lastWrite = std::chrono::steady_clock::now();
+                }
+            }
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (!pending.empty() && (stopping || now - lastWrite >= std::chrono::seconds(1))) {
+            writeBlock();
+            lastWrite = now;
+        }
+        if (stopping) {
+            break;
+        }
+        if (!drained) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+}
+
+void EventLogWriter::writeBlock() {
+    nameIds.clear();
+    names.clear();
+    encoded.clear();
+
+    std::vector<uint32_t> playerIds(pending.size());
+    for (size_t i = 0; i < pending.size(); i++) {
+        auto inserted = nameIds.emplace(pending[i].player, static_cast<uint32_t>(names.size()));
+        if (inserted.second) {
+            names.push_back(pending[i].player);
+        }
+        playerIds[i] = inserted.first->second;
+    }
+    putVarint(encoded, names.size());
+    for (const std::string& name : names) {
+        putVarint(encoded, name.size());
+        encoded.insert(encoded.end(), name.begin(), name.end());
+    }
+
+    const uint64_t firstTime = pending.front().timeMs;
+    for (int c = 0; c < ColumnCount; c++) {
+        column.clear();
+        uint64_t lastTime = firstTime;
+        int64_t lastMax = 0;
+        int64_t lastLower = 0;
+        for (size_t i = 0; i < pending.size(); i++) {
+            const GuessEvent& event = pending[i];
+            switch (c) {
+            case ColumnTime:
+                putVarint(column, zigzag(static_cast<int64_t>(event.timeMs - lastTime)));
+                lastTime = event.timeMs;
+                break;
+            case ColumnPlayer:
+                putVarint(column, playerIds[i]);
+                break;
+            case ColumnFlags:
+                column.push_back(static_cast<uint8_t>((event.result & resultMask) | (event.bot ? flagBot : 0)));
+                break;
+            case ColumnMaxNumber:
+                putVarint(column, zigzag(event.maxNumber - lastMax));
+                lastMax = event.maxNumber;
+                break;
+            case ColumnLowerBound:
+                putVarint(column, zigzag(event.lowerBound - lastLower));
+                lastLower = event.lowerBound;
+                break;
+            case ColumnWidth:
+                putVarint(column, zigzag(static_cast<int64_t>(event.upperBound) - event.lowerBound + 1));
+                break;
+            case ColumnGuess:
+                putVarint(column, zigzag(static_cast<int64_t>(event.guess) - event.lowerBound));
+                break;
+            case ColumnTries:
+                putVarint(column, static_cast<uint32_t>(event.tries));
+                break;
+            case ColumnThink:
+                putVarint(column, event.thinkMs);
+                break;
+            }
+        }
+        putVarint(encoded, column.size());
+        encoded.insert(encoded.end(), column.begin(), column.end());
+    }
+
+    EventBlockHeader header = {};
+    header.events = static_cast<uint32_t>(pending.size());
+    header.bytes = static_cast<uint32_t>(encoded.size());
+    header.checksum = checksum(encoded.data(), encoded.size());
+    header.firstTimeMs = firstTime;
+    header.lastTimeMs = pending.back().timeMs;
+    bool written = lockFile(file) && std::fseek(file, 0, SEEK_END) == 0 &&
+        std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        std::fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+    written = std::fflush(file) == 0 && written;
+    unlockFile(file);
+    if (written) {
+        events.fetch_add(pending.size(), std::memory_order_relaxed);
+        blocks.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(sizeof(header) + encoded.size(), std::memory_order_relaxed);
+    } else {
+        dropped.fetch_add(pending.size(), std::memory_order_relaxed);
+    }
+    pending.clear();
+}
+
+EventLogReader::~EventLogReader() {
+    close();
+}
+
+bool EventLogReader::open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    EventLogHeader header = {};
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, eventMagic, sizeof(eventMagic)) != 0 || header.version != eventVersion) {
+        close();
+        return false;
+    }
+    corrupt = false;
+    return true;
+}
+
+void EventLogReader::close() {
+    if (file != nullptr) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+bool EventLogReader::next(EventBlock& block) {
+    if (file == nullptr) {
+        return false;
+    }
+    EventBlockHeader& header = block.header;
+    size_t got = std::fread(&header, 1, sizeof(header), file);
+    if (got == 0) {
+        return false;
+    }
+    if (got != sizeof(header) || header.bytes > maxBlockBytes) {
+        corrupt = true;
+        return false;
+    }
+    raw.resize(header.bytes);
+    if (std::fread(raw.data(), 1, raw.size(), file) != raw.size() || checksum(raw.data(), raw.size()) != header.checksum) {
+        corrupt = true;
+        return false;
+    }
+
+    const size_t count = header.events;
+    ByteCursor cursor = {raw.data(), raw.data() + raw.size(), true};
+    uint64_t nameCount = cursor.varint();
+    if (nameCount > count) {
+        corrupt = true;
+        return false;
+    }
+    block.names.resize(static_cast<size_t>(nameCount));
+    for (std::string& name : block.names) {
+        uint64_t length = cursor.varint();
+        if (!cursor.ok || length > static_cast<uint64_t>(cursor.end - cursor.at)) {
+            corrupt = true;
+            return false;
+        }
+        name.assign(reinterpret_cast<const char*>(cursor.at), static_cast<size_t>(length));
+        cursor.at += length;
+    }
+
+    block.timeMs.resize(count);
+    block.player.resize(count);
+    block.result.resize(count);
+    block.bot.resize(count);
+    block.maxNumber.resize(count);
+    block.lowerBound.resize(count);
+    block.upperBound.resize(count);
+    block.guess.resize(count);
+    block.tries.resize(count);
+    block.thinkMs.resize(count);
+    for (int c = 0; c < ColumnCount; c++) {
+        uint64_t length = cursor.varint();
+        if (!cursor.ok || length > static_cast<uint64_t>(cursor.end - cursor.at)) {
+            corrupt = true;
+            return false;
+        }
+        ByteCursor col = {cursor.at, cursor.at + length, true};
+        cursor.at += length;
+        uint64_t lastTime = header.firstTimeMs;
+        int64_t lastMax = 0;
+        int64_t lastLower = 0;
+        for (size_t i = 0; i < count && col.ok; i++) {
+            switch (c) {
+            case ColumnTime:
+                lastTime += static_cast<uint64_t>(unzigzag(col.varint()));
+                block.timeMs[i] = lastTime;
+                break;
+            case ColumnPlayer:
+                block.player[i] = static_cast<uint32_t>(col.varint());
+                col.ok = col.ok && block.player[i] < nameCount;
+                break;
+            case ColumnFlags:
+                if (col.at == col.end) {
+                    col.ok = false;
+                    break;
+                }
+                block.result[i] = *col.at & resultMask;
+                block.bot[i] = (*col.at & flagBot) != 0;
+                col.at++;
+                break;
+            case ColumnMaxNumber:
+                lastMax += unzigzag(col.varint());
+                block.maxNumber[i] = static_cast<int32_t>(lastMax);
+                break;
+            case ColumnLowerBound:
+                lastLower += unzigzag(col.varint());
+                block.lowerBound[i] = static_cast<int32_t>(lastLower);
+                break;
+            case ColumnWidth:
+                block.upperBound[i] = static_cast<int32_t>(block.lowerBound[i] + unzigzag(col.varint()) - 1);
+                break;
+            case ColumnGuess:
+                block.guess[i] = static_cast<int32_t>(block.lowerBound[i] + unzigzag(col.varint()));
+                break;
+            case ColumnTries:
+                block.tries[i] = static_cast<int32_t>(col.varint());
+                break;
+            case ColumnThink:
+                block.thinkMs[i] = static_cast<uint32_t>(col.varint());
+                break;
+            }
+        }
+        if (!col.ok) {
+            corrupt = true;
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "spsc_ring.h"
+
+// One guess as it happened: the window it was made in, the answer and how
+// long the player took since the turn started or their previous guess.
+struct GuessEvent {
+    static constexpr size_t maxNameLength = 79;
+
+    uint64_t timeMs;
+    uint32_t thinkMs;
+    int32_t maxNumber;
+    int32_t lowerBound;
+    int32_t upperBound;
+    int32_t guess;
+    int32_t tries;
+    uint8_t result;
+    bool bot;
+    char player[maxNameLength + 1];
+};
+
+// Wall clock in milliseconds, the time base of GuessEvent.
+uint64_t eventClockMs();
+GuessEvent makeGuessEvent(const std::string& player, bool bot);
+
+// On-disk layout: a file header, then self-contained blocks. Each block
+// stores its player names once and every field as its own column of
+// delta/zigzag varints, so a reader needs one block in memory at a time.
+// A torn trailing block from a crash is detected by size and checksum.
+// Processes sharing a log append whole blocks under an flock on it.
+struct EventLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t blockEvents;
+};
+
+struct EventBlockHeader {
+    uint32_t events;
+    uint32_t bytes;
+    uint32_t checksum;
+    uint32_t reserved;
+    uint64_t firstTimeMs;
+    uint64_t lastTimeMs;
+};
+
+struct EventLogStats {
+    uint64_t events;
+    uint64_t dropped;
+    uint64_t blocks;
+    uint64_t bytes;
+};
+
+// Append-only writer. append() copies the event into a lock-free ring and
+// returns; a writer thread encodes full blocks (or whatever is pending
+// after a quiet second) and writes them out. Events are dropped and
+// counted if the ring is ever full rather than stalling the frame.
+class EventLogWriter {
+public:
+    static constexpr uint32_t blockEvents = 4096;
+
+    // The ring only has to absorb bursts between the writer's 20 ms
+    // wake-ups; batch producers like dice_sim want a much larger one.
+    explicit EventLogWriter(size_t ringCapacity = 1024);
+    ~EventLogWriter();
+    EventLogWriter(const EventLogWriter&) = delete;
+    EventLogWriter& operator=(const EventLogWriter&) = delete;
+
+    bool open(const std::string& path);
+    // Writes out everything pending and stops the writer thread.
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    void append(const GuessEvent& event);
+    // Like append() but leaves a full ring to the caller instead of
+    // dropping; batch producers retry.
+    bool tryAppend(const GuessEvent& event);
+    EventLogStats stats() const;
+
+private:
+    bool recover();
+    void writeLoop();
+    void writeBlock();
+
+    FILE* file = nullptr;
+    SpscRing<GuessEvent> ring;
+    std::vector<GuessEvent> pending;
+    std::unordered_map<std::string, uint32_t> nameIds;
+    std::vector<std::string> names;
+    std::vector<uint8_t> column;
+    std::vector<uint8_t> encoded;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> events{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+// Columns of one decoded block. Names index into `names`.
+struct EventBlock {
+    EventBlockHeader header;
+    std::vector<std::string> names;
+    std::vector<uint64_t> timeMs;
+    std::vector<uint32_t> player;
+    std::vector<uint8_t> result;
+    std::vector<uint8_t> bot;
+    std::vector<int32_t> maxNumber;
+    std::vector<int32_t> lowerBound;
+    std::vector<int32_t> upperBound;
+    std::vector<int32_t> guess;
+    std::vector<int32_t> tries;
+    std::vector<uint32_t> thinkMs;
+
+    size_t size() const { return timeMs.size(); }
+};
+
+// Streams a log block by block; the buffers are reused between blocks.
+class EventLogReader {
+public:
+    EventLogReader() = default;
+    ~EventLogReader();
+    EventLogReader(const EventLogReader&) = delete;
+    EventLogReader& operator=(const EventLogReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    // Decodes the next block; false at the end of the log or at the first
+    // damaged block, which damaged() then reports.
+    bool next(EventBlock& block);
+    bool damaged() const { return corrupt; }
+
+private:
+    FILE* file = nullptr;
+    std::vector<uint8_t> raw;
+    bool corrupt = false;
+};
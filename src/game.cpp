@@ -0,0 +1,48 @@
+#include "game.h"
+
+#include <algorithm>
+
+void GameSession::reset() {
+    for (auto& player : players) {
+        player.tries = 0;
+    }
+    currentPlayer = 0;
+    finished = false;
+}
+
+void GameSession::beginTurn(int target) {
+    targetNumber = target;
+    lowerBound = 1;
+    upperBound = maxNumber;
+}
+
+GuessResult GameSession::guess(int value) {
+    players[currentPlayer].tries++;
+    if (value == targetNumber) {
+        currentPlayer++;
+        if (currentPlayer >= static_cast<int>(players.size())) {
+            finished = true;
+            return GuessResult::GameOver;
+        }
+        return GuessResult::Correct;
+    }
+    // The window only ever shrinks, whatever the caller passed in.
+    if (value < targetNumber) {
+        lowerBound = std::max(lowerBound, value + 1);
+        return GuessResult::Higher;
+    }
+    upperBound = std::min(upperBound, value - 1);
+    return GuessResult::Lower;
+}
+
+GameOutcome GameSession::outcome() const {
+    GameOutcome result = {0, players[0].tries, 1};
+    for (size_t i = 1; i < players.size(); i++) {
+        if (players[i].tries < result.minTries) {
+            result = {static_cast<int>(i), players[i].tries, 1};
+        } else if (players[i].tries == result.minTries) {
+            result.winners++;
+        }
+    }
+    return result;
+}
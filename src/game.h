@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct Player {
+    std::string name;
+    int tries;
+    int bestScore;
+    bool bot = false;
+};
+
+enum class GuessResult {
+    Higher,
+    Lower,
+    Correct,
+    GameOver
+};
+
+struct GameOutcome {
+    int winner;
+    int minTries;
+    int winners;
+};
+
+// Turn rules shared by the window game and the headless tools. The caller
+// draws targets and feeds them in through beginTurn().
+class GameSession {
+public:
+    std::vector<Player> players;
+    int maxNumber = 6;
+    int currentPlayer = 0;
+    int targetNumber = 0;
+    int lowerBound = 1;
+    int upperBound = 6;
+    bool finished = false;
+
+    void reset();
+    void beginTurn(int target);
+    GuessResult guess(int value);
+    bool inWindow(int value) const { return value >= lowerBound && value <= upperBound; }
+    GameOutcome outcome() const;
+};
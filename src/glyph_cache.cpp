@@ -0,0 +1,208 @@
+#include "glyph_cache.h"
+
+#include <rlgl.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "utf8.h"
+
+static const int minAtlasWidth = 512;
+static const int maxAtlasHeight = 1024;
+static const int initialRows = 1;
+static const int bytesPerPixel = 2;
+
+GlyphCache::~GlyphCache() {
+    unload();
+}
+
+void GlyphCache::init(const GameAssets& assets) {
+    unload();
+    if (assets.fontAtlas.data == nullptr || assets.glyphs.empty()) {
+        current = GetFontDefault();
+        return;
+    }
+    Image baked = ImageCopy(assets.fontAtlas);
+    ImageFormat(&baked, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA);
+    bakedCount = static_cast<int>(assets.glyphs.size());
+    bakedHeight = baked.height;
+    atlasWidth = std::max(baked.width, minAtlasWidth);
+    fontFile = assets.fontFile;
+    fontFileSize = assets.fontFileSize;
+    cellSize = assets.fontBaseSize * 3 / 2 + 2 * fontGlyphPadding;
+    columns = atlasWidth / cellSize;
+    maxRows = fontFile != nullptr ? std::max(0, (maxAtlasHeight - bakedHeight) / cellSize) : 0;
+    rows = std::min(initialRows, maxRows);
+
+    pixels.assign(static_cast<size_t>(atlasWidth) * (bakedHeight + rows * cellSize) * bytesPerPixel, 0);
+    const unsigned char* source = static_cast<const unsigned char*>(baked.data);
+    for (int y = 0; y < baked.height; y++) {
+        std::memcpy(&pixels[static_cast<size_t>(y) * atlasWidth * bytesPerPixel],
+            source + static_cast<size_t>(y) * baked.width * bytesPerPixel, static_cast<size_t>(baked.width) * bytesPerPixel);
+    }
+    UnloadImage(baked);
+
+    // Room for every cell up front: raylib keeps pointers to these arrays
+    // inside the Font that callers copy.
+    int capacity = bakedCount + columns * maxRows;
+    current.baseSize = assets.fontBaseSize;
+    current.glyphCount = bakedCount;
+    current.glyphPadding = fontGlyphPadding;
+    current.recs = static_cast<Rectangle*>(std::calloc(capacity, sizeof(Rectangle)));
+    current.glyphs = static_cast<GlyphInfo*>(std::calloc(capacity, sizeof(GlyphInfo)));
+    for (int i = 0; i < bakedCount; i++) {
+        const PackGlyph& glyph = assets.glyphs[i];
+        current.recs[i] = {glyph.x, glyph.y, glyph.width, glyph.height};
+        current.glyphs[i].value = glyph.value;
+        current.glyphs[i].offsetX = glyph.offsetX;
+        current.glyphs[i].offsetY = glyph.offsetY;
+        current.glyphs[i].advanceX = glyph.advanceX;
+    }
+    slots.reserve(static_cast<size_t>(columns * maxRows));
+    ownsFont = true;
+    upload();
+}
+
+void GlyphCache::unload() {
+    if (ownsFont) {
+        UnloadTexture(current.texture);
+        std::free(current.recs);
+        std::free(current.glyphs);
+    }
+    current = {};
+    ownsFont = false;
+    fontFile = nullptr;
+    maxRows = rows = 0;
+    pixels.clear();
+    slots.clear();
+    slotOf.clear();
+}
+
+void GlyphCache::upload() {
+    if (current.texture.id != 0) {
+        // Text queued earlier this frame still samples the old atlas.
+        rlDrawRenderBatchActive();
+        UnloadTexture(current.texture);
+    }
+    Image image = {};
+    image.data = pixels.data();
+    image.width = atlasWidth;
+    image.height = bakedHeight + rows * cellSize;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA;
+    current.texture = LoadTextureFromImage(image);
+    SetTextureFilter(current.texture, TEXTURE_FILTER_BILINEAR);
+}
+
+void GlyphCache::require(const char* text) {
+    if (maxRows == 0) {
+        return;
+    }
+    for (const char* c = text; *c != 0;) {
+        if (static_cast<unsigned char>(*c) < 0x80) {
+            c++;
+            continue;
+        }
+        int codepoint = 0;
+        c += utf8Decode(c, codepoint);
+        auto found = slotOf.find(codepoint);
+        if (found != slotOf.end()) {
+            slots[found->second].lastUsed = frame;
+            continue;
+        }
+        int slot = slotFor(codepoint);
+        if (slot < 0) {
+            misses++;
+            continue;
+        }
+        rasterize(slot, codepoint);
+    }
+}
+
+bool GlyphCache::grow() {
+    if (rows >= maxRows) {
+        return false;
+    }
+    rows = std::min(std::max(rows * 2, 1), maxRows);
+    pixels.resize(static_cast<size_t>(atlasWidth) * (bakedHeight + rows * cellSize) * bytesPerPixel, 0);
+    upload();
+    return true;
+}
+
+int GlyphCache::slotFor(int codepoint) {
+    size_t cells = static_cast<size_t>(columns * rows);
+    if (slots.size() == cells && grow()) {
+        cells = static_cast<size_t>(columns * rows);
+    }
+    int slot = -1;
+    if (slots.size() < cells) {
+        slot = static_cast<int>(slots.size());
+        slots.push_back({});
+        current.glyphCount = bakedCount + static_cast<int>(slots.size());
+    } else {
+        // Glyphs used this frame stay, or the label drawing them would
+        // lose a character it already measured.
+        uint64_t oldest = frame;
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].lastUsed < oldest) {
+                oldest = slots[i].lastUsed;
+                slot = static_cast<int>(i);
+            }
+        }
+        if (slot < 0) {
+            return -1;
+        }
+        slotOf.erase(slots[slot].codepoint);
+        evictions++;
+    }
+    slots[slot] = {codepoint, frame};
+    slotOf[codepoint] = slot;
+    return slot;
+}
+
+void GlyphCache::rasterize(int slot, int codepoint) {
+    const int padding = fontGlyphPadding;
+    const int cellX = (slot % columns) * cellSize;
+    const int cellY = bakedHeight + (slot / columns) * cellSize;
+    cell.assign(static_cast<size_t>(cellSize) * cellSize * bytesPerPixel, 0);
+
+    GlyphInfo& glyph = current.glyphs[bakedCount + slot];
+    glyph = {};
+    glyph.value = codepoint;
+    int width = 0;
+    int height = 0;
+    int wanted = codepoint;
+    GlyphInfo* info = LoadFontData(fontFile, fontFileSize, current.baseSize, &wanted, 1, FONT_DEFAULT);
+    if (info != nullptr) {
+        glyph.offsetX = info->offsetX;
+        glyph.offsetY = info->offsetY;
+        glyph.advanceX = info->advanceX;
+        // Same layout GenImageFontAtlas produces: white, coverage in alpha.
+        const unsigned char* gray = static_cast<const unsigned char*>(info->image.data);
+        if (gray != nullptr) {
+            width = std::min(info->image.width, cellSize - 2 * padding);
+            height = std::min(info->image.height, cellSize - 2 * padding);
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    size_t at = (static_cast<size_t>(y + padding) * cellSize + x + padding) * bytesPerPixel;
+                    cell[at] = 255;
+                    cell[at + 1] = gray[y * info->image.width + x];
+                }
+            }
+        }
+        UnloadFontData(info, 1);
+    }
+    current.recs[bakedCount + slot] = {static_cast<float>(cellX + padding), static_cast<float>(cellY + padding),
+        static_cast<float>(width), static_cast<float>(height)};
+
+    for (int y = 0; y < cellSize; y++) {
+        std::memcpy(&pixels[(static_cast<size_t>(cellY + y) * atlasWidth + cellX) * bytesPerPixel],
+            &cell[static_cast<size_t>(y) * cellSize * bytesPerPixel], static_cast<size_t>(cellSize) * bytesPerPixel);
+    }
+    UpdateTextureRec(current.texture, {static_cast<float>(cellX), static_cast<float>(cellY),
+        static_cast<float>(cellSize), static_cast<float>(cellSize)}, cell.data());
+    rasterized++;
+}
+
+GlyphCacheStats GlyphCache::stats() const {
+    return {static_cast<int>(slots.size()), columns * maxRows, rasterized, evictions, misses};
+}
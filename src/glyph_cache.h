@@ -0,0 +1,75 @@
+#pragma once
+
+#include <raylib.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "assets.h"
+
+struct GlyphCacheStats {
+    int resident;
+    int capacity;
+    uint64_t rasterized;
+    uint64_t evictions;
+    uint64_t misses;
+};
+
+// The game font: the baked ASCII atlas plus glyphs for any other codepoint,
+// rasterized from the TTF the first time a label needs them. They live in
+// fixed-size cells below the ASCII glyphs in the same texture, so raylib's
+// text functions draw them like any other glyph. The cell area doubles
+// when it fills up, to a height limit; after that the least recently used
+// glyph not needed this frame gives up its cell. A codepoint that finds no
+// cell draws as raylib's '?' fallback.
+class GlyphCache {
+public:
+    GlyphCache() = default;
+    ~GlyphCache();
+    GlyphCache(const GlyphCache&) = delete;
+    GlyphCache& operator=(const GlyphCache&) = delete;
+
+    // Render thread only. Without a TTF in `assets` only the baked glyphs
+    // are available; without an atlas it falls back to raylib's font.
+    void init(const GameAssets& assets);
+    void unload();
+
+    // The texture is replaced when the atlas grows, so always draw with
+    // the current font rather than a copy kept across frames.
+    Font& font() { return current; }
+    // Makes every codepoint of `text` resident and marks it used.
+    void require(const char* text);
+    void nextFrame() { frame++; }
+    GlyphCacheStats stats() const;
+
+private:
+    struct Slot {
+        int codepoint;
+        uint64_t lastUsed;
+    };
+
+    int slotFor(int codepoint);
+    bool grow();
+    void rasterize(int slot, int codepoint);
+    void upload();
+
+    Font current = {};
+    bool ownsFont = false;
+    const unsigned char* fontFile = nullptr;
+    int fontFileSize = 0;
+    int bakedCount = 0;
+    int cellSize = 0;
+    int columns = 0;
+    int bakedHeight = 0;
+    int rows = 0;
+    int maxRows = 0;
+    // CPU copy of the atlas (gray + alpha), kept so growing can re-upload.
+    std::vector<unsigned char> pixels;
+    std::vector<unsigned char> cell;
+    int atlasWidth = 0;
+    std::vector<Slot> slots;
+    std::unordered_map<int, int> slotOf;
+    uint64_t frame = 1;
+    uint64_t rasterized = 0;
+    uint64_t evictions = 0;
+    uint64_t misses = 0;
+};
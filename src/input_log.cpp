@@ -0,0 +1,206 @@
+#include "input_log.h"
+
+#include <cstddef>
+#include <cstring>
+
+static const char logMagic[8] = {'D', 'I', 'C', 'E', 'R', 'E', 'C', '1'};
+static const uint32_t logVersion = 1;
+// The recorder pushes the header and pending frames to the file this
+// often, so a crashed session still leaves a replayable log.
+static const uint32_t syncFrames = 60;
+
+// Frame record: one flag byte, then only the fields it announces.
+enum FrameFlag : uint8_t {
+    FlagMouseMoved = 1 << 0,
+    FlagPressed = 1 << 1,
+    FlagKeys = 1 << 2,
+    FlagWheel = 1 << 3,
+    FlagChars = 1 << 4
+};
+
+static void writeVarint(FILE* file, uint32_t value) {
+    while (value >= 0x80) {
+        std::fputc(static_cast<int>((value & 0x7F) | 0x80), file);
+        value >>= 7;
+    }
+    std::fputc(static_cast<int>(value), file);
+}
+
+static bool readVarint(FILE* file, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        int byte = std::fgetc(file);
+        if (byte == EOF) {
+            return false;
+        }
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Decodes one frame record; false at the end of the file or at a record
+// cut short by a crash.
+static bool readFrame(FILE* file, FrameInput& input, int16_t& lastX, int16_t& lastY) {
+    int flags = std::fgetc(file);
+    if (flags == EOF) {
+        return false;
+    }
+    input = FrameInput{};
+    bool ok = true;
+    if (flags & FlagMouseMoved) {
+        ok = std::fread(&lastX, sizeof(lastX), 1, file) == 1 && std::fread(&lastY, sizeof(lastY), 1, file) == 1;
+    }
+    input.mouseX = lastX;
+    input.mouseY = lastY;
+    input.mousePressed = (flags & FlagPressed) != 0;
+    if (ok && (flags & FlagKeys)) {
+        ok = std::fread(&input.keys, sizeof(input.keys), 1, file) == 1;
+    }
+    if (ok && (flags & FlagWheel)) {
+        int8_t wheel = 0;
+        ok = std::fread(&wheel, sizeof(wheel), 1, file) == 1;
+        input.wheel = wheel;
+    }
+    if (ok && (flags & FlagChars)) {
+        int count = std::fgetc(file);
+        ok = count != EOF && count <= FrameInput::maxChars;
+        for (int i = 0; ok && i < count; i++) {
+            uint32_t value = 0;
+            ok = readVarint(file, value);
+            input.chars[i] = static_cast<int>(value);
+        }
+        if (ok) {
+            input.charCount = count;
+        }
+    }
+    return ok;
+}
+
+InputRecorder::~InputRecorder() {
+    close();
+}
+
+bool InputRecorder::open(const std::string& path, uint64_t seed, int diceFaceHeight) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    InputLogHeader header = {};
+    std::memcpy(header.magic, logMagic, sizeof(logMagic));
+    header.version = logVersion;
+    header.diceFaceHeight = diceFaceHeight;
+    header.seed = seed;
+    frames = 0;
+    lastX = lastY = 0;
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void InputRecorder::write(const FrameInput& input) {
+    if (file == nullptr) {
+        return;
+    }
+    int16_t x = static_cast<int16_t>(input.mouseX);
+    int16_t y = static_cast<int16_t>(input.mouseY);
+    uint8_t flags = 0;
+    if (x != lastX || y != lastY) flags |= FlagMouseMoved;
+    if (input.mousePressed) flags |= FlagPressed;
+    if (input.keys != 0) flags |= FlagKeys;
+    if (input.wheel != 0) flags |= FlagWheel;
+    if (input.charCount > 0) flags |= FlagChars;
+
+    std::fputc(flags, file);
+    if (flags & FlagMouseMoved) {
+        std::fwrite(&x, sizeof(x), 1, file);
+        std::fwrite(&y, sizeof(y), 1, file);
+        lastX = x;
+        lastY = y;
+    }
+    if (flags & FlagKeys) {
+        std::fwrite(&input.keys, sizeof(input.keys), 1, file);
+    }
+    if (flags & FlagWheel) {
+        int8_t wheel = static_cast<int8_t>(input.wheel);
+        std::fwrite(&wheel, sizeof(wheel), 1, file);
+    }
+    if (flags & FlagChars) {
+        std::fputc(input.charCount, file);
+        for (int i = 0; i < input.charCount; i++) {
+            writeVarint(file, static_cast<uint32_t>(input.chars[i]));
+        }
+    }
+    frames++;
+    if (frames % syncFrames == 0) {
+        writeFrameCount();
+    }
+}
+
+void InputRecorder::writeFrameCount() {
+    long end = std::ftell(file);
+    std::fseek(file, static_cast<long>(offsetof(InputLogHeader, frameCount)), SEEK_SET);
+    std::fwrite(&frames, sizeof(frames), 1, file);
+    std::fseek(file, end, SEEK_SET);
+    std::fflush(file);
+}
+
+void InputRecorder::close() {
+    if (file == nullptr) {
+        return;
+    }
+    writeFrameCount();
+    std::fclose(file);
+    file = nullptr;
+}
+
+InputReplay::~InputReplay() {
+    close();
+}
+
+bool InputReplay::open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, logMagic, sizeof(logMagic)) != 0 || header.version != logVersion) {
+        close();
+        return false;
+    }
+    // The header count lags behind the frames after a crash, so count the
+    // complete frames instead; a torn last one is left unread. The file
+    // itself is never modified.
+    FrameInput input;
+    uint32_t complete = 0;
+    lastX = lastY = 0;
+    while (readFrame(file, input, lastX, lastY)) {
+        complete++;
+    }
+    header.frameCount = complete;
+    std::fseek(file, static_cast<long>(sizeof(header)), SEEK_SET);
+    frames = 0;
+    lastX = lastY = 0;
+    return true;
+}
+
+void InputReplay::close() {
+    if (file != nullptr) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+bool InputReplay::next(FrameInput& input) {
+    if (file == nullptr || frames >= header.frameCount || !readFrame(file, input, lastX, lastY)) {
+        return false;
+    }
+    frames++;
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "app.h"
+
+// Compact per-frame input log. The header carries everything the game
+// draws from outside the input stream (RNG seed, dice face height) so a
+// replay reproduces the recorded session frame for frame.
+struct InputLogHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t diceFaceHeight;
+    uint64_t seed;
+    uint32_t frameCount;
+    uint32_t reserved;
+};
+
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    ~InputRecorder();
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    bool open(const std::string& path, uint64_t seed, int diceFaceHeight);
+    void write(const FrameInput& input);
+    // Patches the frame count into the header and closes the file.
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+private:
+    void writeFrameCount();
+
+    FILE* file = nullptr;
+    uint32_t frames = 0;
+    int16_t lastX = 0;
+    int16_t lastY = 0;
+};
+
+class InputReplay {
+public:
+    InputReplay() = default;
+    ~InputReplay();
+    InputReplay(const InputReplay&) = delete;
+    InputReplay& operator=(const InputReplay&) = delete;
+
+    // Replays every complete frame in the file, also from a log whose
+    // recorder never closed it; a torn last frame is skipped. Read-only.
+    bool open(const std::string& path);
+    void close();
+    // Fills `input` with the next recorded frame; false once the log ends.
+    bool next(FrameInput& input);
+
+    uint64_t seed() const { return header.seed; }
+    int diceFaceHeight() const { return header.diceFaceHeight; }
+    uint32_t frameCount() const { return header.frameCount; }
+    uint32_t framesRead() const { return frames; }
+    bool isOpen() const { return file != nullptr; }
+
+private:
+    FILE* file = nullptr;
+    InputLogHeader header = {};
+    uint32_t frames = 0;
+    int16_t lastX = 0;
+    int16_t lastY = 0;
+};
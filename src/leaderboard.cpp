@@ -0,0 +1,211 @@
+#include "leaderboard.h"
+
+#include <algorithm>
+
+static int64_t effectiveBest(const ScoreEntry& entry) {
+    return entry.bestScore > 0 ? entry.bestScore : INT64_MAX;
+}
+
+bool RankTree::less(uint32_t a, uint32_t b) const {
+    const ScoreEntry& x = (*entries)[a];
+    const ScoreEntry& y = (*entries)[b];
+    if (order == RankOrder::BestScore) {
+        if (effectiveBest(x) != effectiveBest(y)) {
+            return effectiveBest(x) < effectiveBest(y);
+        }
+        if (x.gamesPlayed != y.gamesPlayed) {
+            return x.gamesPlayed > y.gamesPlayed;
+        }
+    } else {
+        if (x.gamesPlayed != y.gamesPlayed) {
+            return x.gamesPlayed > y.gamesPlayed;
+        }
+        if (effectiveBest(x) != effectiveBest(y)) {
+            return effectiveBest(x) < effectiveBest(y);
+        }
+    }
+    return a < b;
+}
+
+uint32_t RankTree::nextPriority() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+void RankTree::pull(uint32_t node) {
+    nodes[node].size = sizeOf(nodes[node].left) + sizeOf(nodes[node].right) + 1;
+}
+
+void RankTree::build(uint32_t count) {
+    nodes.assign(count, Node{nil, nil, 1, 0});
+    std::vector<uint32_t> ids(count);
+    for (uint32_t i = 0; i < count; i++) {
+        ids[i] = i;
+        nodes[i].priority = nextPriority();
+    }
+    std::sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) { return less(a, b); });
+
+    std::vector<uint32_t> spine;
+    for (uint32_t id : ids) {
+        uint32_t last = nil;
+        while (!spine.empty() && nodes[spine.back()].priority < nodes[id].priority) {
+            last = spine.back();
+            spine.pop_back();
+        }
+        nodes[id].left = last;
+        if (!spine.empty()) {
+            nodes[spine.back()].right = id;
+        }
+        spine.push_back(id);
+    }
+    root = spine.empty() ? nil : spine.front();
+
+    // Children always have lower priority than their parent, so pulling in
+    // ascending priority order fixes sizes bottom-up.
+    std::sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) { return nodes[a].priority < nodes[b].priority; });
+    for (uint32_t id : ids) {
+        pull(id);
+    }
+}
+
+void RankTree::split(uint32_t node, uint32_t id, uint32_t& left, uint32_t& right) {
+    if (node == nil) {
+        left = right = nil;
+        return;
+    }
+    if (less(node, id)) {
+        split(nodes[node].right, id, nodes[node].right, right);
+        left = node;
+    } else {
+        split(nodes[node].left, id, left, nodes[node].left);
+        right = node;
+    }
+    pull(node);
+}
+
+uint32_t RankTree::merge(uint32_t left, uint32_t right) {
+    if (left == nil) {
+        return right;
+    }
+    if (right == nil) {
+        return left;
+    }
+    if (nodes[left].priority > nodes[right].priority) {
+        nodes[left].right = merge(nodes[left].right, right);
+        pull(left);
+        return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    pull(right);
+    return right;
+}
+
+void RankTree::insert(uint32_t id) {
+    if (id >= nodes.size()) {
+        nodes.resize(id + 1, Node{nil, nil, 1, 0});
+    }
+    nodes[id] = Node{nil, nil, 1, nextPriority()};
+    uint32_t left, right;
+    split(root, id, left, right);
+    root = merge(merge(left, id), right);
+}
+
+uint32_t RankTree::detachFirst(uint32_t node) {
+    if (nodes[node].left == nil) {
+        return nodes[node].right;
+    }
+    nodes[node].left = detachFirst(nodes[node].left);
+    pull(node);
+    return node;
+}
+
+void RankTree::erase(uint32_t id) {
+    uint32_t left, right;
+    split(root, id, left, right);
+    // `id` is now the smallest key of `right`.
+    root = merge(left, right == nil ? nil : detachFirst(right));
+}
+
+uint32_t RankTree::rankOf(uint32_t id) const {
+    uint32_t rank = 0;
+    uint32_t node = root;
+    while (node != nil && node != id) {
+        if (less(id, node)) {
+            node = nodes[node].left;
+        } else {
+            rank += sizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        }
+    }
+    return node == nil ? rank : rank + sizeOf(nodes[node].left);
+}
+
+uint32_t RankTree::select(uint32_t rank) const {
+    uint32_t node = root;
+    while (node != nil) {
+        uint32_t leftSize = sizeOf(nodes[node].left);
+        if (rank < leftSize) {
+            node = nodes[node].left;
+        } else if (rank == leftSize) {
+            return node;
+        } else {
+            rank -= leftSize + 1;
+            node = nodes[node].right;
+        }
+    }
+    return nil;
+}
+
+void Leaderboard::build(const ScoreStore& store) {
+    entries.clear();
+    ids.clear();
+    entries.reserve(store.size());
+    ids.reserve(store.size());
+    for (uint32_t i = 0; i < store.size(); i++) {
+        const ScoreRecord& record = store.record(i);
+        entries.push_back({record.name, record.bestScore, record.gamesPlayed});
+        ids.emplace(entries.back().name, i);
+    }
+    byBest.build(size());
+    byGames.build(size());
+}
+
+void Leaderboard::update(uint32_t id, const ScoreEntry& entry) {
+    if (id < entries.size()) {
+        byBest.erase(id);
+        byGames.erase(id);
+        entries[id] = entry;
+    } else {
+        entries.resize(id + 1);
+        entries[id] = entry;
+        ids[entry.name] = id;
+    }
+    byBest.insert(id);
+    byGames.insert(id);
+}
+
+int Leaderboard::findId(const std::string& name) const {
+    auto found = ids.find(name);
+    return found != ids.end() ? static_cast<int>(found->second) : -1;
+}
+
+int Leaderboard::recordGame(const std::string& name, int tries) {
+    int id = findId(name);
+    ScoreEntry entry = id >= 0 ? entries[id] : ScoreEntry{name, 0, 0};
+    if (entry.gamesPlayed == 0 || tries < entry.bestScore || entry.bestScore == 0) {
+        entry.bestScore = tries;
+    }
+    entry.gamesPlayed++;
+    update(id >= 0 ? static_cast<uint32_t>(id) : size(), entry);
+    return entry.bestScore;
+}
+
+void Leaderboard::top(uint32_t count, RankOrder order, std::vector<uint32_t>& out) const {
+    out.clear();
+    count = std::min(count, size());
+    for (uint32_t rank = 0; rank < count; rank++) {
+        out.push_back(at(rank, order));
+    }
+}
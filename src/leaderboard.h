@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "score_store.h"
+
+enum class RankOrder {
+    BestScore,
+    GamesPlayed
+};
+
+// Order-statistic treap over scoreboard ids. Nodes live in one pool and
+// are addressed by index; every node carries its subtree size so rank and
+// select are O(log n).
+class RankTree {
+public:
+    RankTree(const std::vector<ScoreEntry>* entries, RankOrder order) : entries(entries), order(order) {}
+
+    void build(uint32_t count);
+    void insert(uint32_t id);
+    void erase(uint32_t id);
+    uint32_t size() const { return root == nil ? 0 : nodes[root].size; }
+    uint32_t rankOf(uint32_t id) const;
+    uint32_t select(uint32_t rank) const;
+
+private:
+    static constexpr uint32_t nil = 0xFFFFFFFFu;
+
+    struct Node {
+        uint32_t left;
+        uint32_t right;
+        uint32_t size;
+        uint32_t priority;
+    };
+
+    bool less(uint32_t a, uint32_t b) const;
+    uint32_t sizeOf(uint32_t node) const { return node == nil ? 0 : nodes[node].size; }
+    void pull(uint32_t node);
+    void split(uint32_t node, uint32_t id, uint32_t& left, uint32_t& right);
+    uint32_t merge(uint32_t left, uint32_t right);
+    uint32_t detachFirst(uint32_t node);
+    uint32_t nextPriority();
+
+    const std::vector<ScoreEntry>* entries;
+    RankOrder order;
+    std::vector<Node> nodes;
+    uint32_t root = nil;
+    uint32_t seed = 0x2545F491u;
+};
+
+// In-memory ranking of every scoreboard entry, kept in both sort orders.
+// build() gives ids in store record order; a name first seen afterwards
+// gets the next free id, whatever index it ends up with in the store.
+class Leaderboard {
+public:
+    Leaderboard() : byBest(&entries, RankOrder::BestScore), byGames(&entries, RankOrder::GamesPlayed) {}
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+
+    void build(const ScoreStore& store);
+    void update(uint32_t id, const ScoreEntry& entry);
+    // Same merge as ScoreStore::recordGame, on the in-memory entry.
+    int recordGame(const std::string& name, int tries);
+
+    uint32_t size() const { return static_cast<uint32_t>(entries.size()); }
+    const ScoreEntry& entry(uint32_t id) const { return entries[id]; }
+    int findId(const std::string& name) const;
+    uint32_t rankOf(uint32_t id, RankOrder order) const { return tree(order).rankOf(id); }
+    uint32_t at(uint32_t rank, RankOrder order) const { return tree(order).select(rank); }
+    void top(uint32_t count, RankOrder order, std::vector<uint32_t>& out) const;
+
+private:
+    const RankTree& tree(RankOrder order) const { return order == RankOrder::BestScore ? byBest : byGames; }
+
+    std::vector<ScoreEntry> entries;
+    std::unordered_map<std::string, uint32_t> ids;
+    RankTree byBest;
+    RankTree byGames;
+};
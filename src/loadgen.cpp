@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include "room_protocol.h"
+
+struct LoadOptions {
+    const char* host = "127.0.0.1";
+    uint16_t port = 7777;
+    int rooms = 1000;
+    int players = 2;
+    int threads = 1;
+    double seconds = 10.0;
+    int thinkMs = 0;
+    uint32_t firstRoom = 1;
+};
+
+// Latency histogram in microseconds; the last bucket collects the tail.
+static const size_t latencyBuckets = 100000;
+
+struct LoadStats {
+    uint64_t turns = 0;
+    uint64_t games = 0;
+    uint64_t errors = 0;
+    uint64_t maxLatencyUs = 0;
+    std::vector<uint64_t> latency;
+};
+
+struct Bot {
+    int fd = -1;
+    int seat = -1;
+    bool waiting = false;
+    int32_t guess = 0;
+    std::chrono::steady_clock::time_point sentAt;
+    WireBuffer wire;
+};
+
+struct PendingGuess {
+    std::chrono::steady_clock::time_point due;
+    size_t bot;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<bool> stopping{false};
+
+static bool sendGuess(Bot& bot, int32_t value) {
+    GuessMsg msg = {value};
+    appendMessage(bot.wire, MsgType::Guess, msg);
+    bot.guess = value;
+    bot.waiting = true;
+    bot.sentAt = Clock::now();
+    return flushOut(bot.fd, bot.wire);
+}
+
+// Plays `rooms` tables starting at `firstRoom`, every seat on its own
+// socket, guessing the midpoint of the open window like dice_sim's binary
+// strategy.
+static void runBots(const LoadOptions& options, uint32_t firstRoom, int rooms, LoadStats& stats) {
+    stats.latency.assign(latencyBuckets, 0);
+    int epollFd = ::epoll_create1(0);
+    std::vector<Bot> bots(static_cast<size_t>(rooms * options.players));
+    for (size_t i = 0; i < bots.size(); i++) {
+        Bot& bot = bots[i];
+        bot.fd = connectTcp(options.host, options.port);
+        if (bot.fd < 0) {
+            std::fprintf(stderr, "Nao foi possivel conectar a %s:%u\n", options.host, options.port);
+            stats.errors++;
+            continue;
+        }
+        uint32_t room = firstRoom + static_cast<uint32_t>(i / options.players);
+        std::string name = "bot" + std::to_string(room) + "-" + std::to_string(i % options.players);
+        JoinMsg join = {protocolVersion, room, static_cast<uint8_t>(options.players), static_cast<uint8_t>(name.size())};
+        appendMessage(bot.wire, MsgType::Join, &join, sizeof(join), name.data(), name.size());
+        flushOut(bot.fd, bot.wire);
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, bot.fd, &event);
+    }
+
+    // A guess is answered by the next Turn or GameOver on the same socket.
+    auto answered = [&stats](Bot& bot) {
+        if (!bot.waiting) {
+            return;
+        }
+        uint64_t us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - bot.sentAt).count());
+        stats.latency[std::min<uint64_t>(us, latencyBuckets - 1)]++;
+        stats.maxLatencyUs = std::max(stats.maxLatencyUs, us);
+        stats.turns++;
+        bot.waiting = false;
+    };
+
+    std::deque<PendingGuess> thinking;
+    const int maxEvents = 256;
+    epoll_event events[maxEvents];
+    while (!stopping.load(std::memory_order_relaxed)) {
+        int timeoutMs = 100;
+        if (!thinking.empty()) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(thinking.front().due - Clock::now());
+            timeoutMs = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(wait.count(), timeoutMs)));
+        }
+        int count = ::epoll_wait(epollFd, events, maxEvents, timeoutMs);
+        for (int e = 0; e < count; e++) {
+            Bot& bot = bots[events[e].data.u64];
+            if (!readAvailable(bot.fd, bot.wire)) {
+                stats.errors++;
+                ::epoll_ctl(epollFd, EPOLL_CTL_DEL, bot.fd, nullptr);
+                continue;
+            }
+            drainMessages(bot.wire, [&](MsgType type, const uint8_t* payload, size_t size) {
+                if (type == MsgType::Joined && size == sizeof(JoinedMsg)) {
+                    JoinedMsg joined;
+                    std::memcpy(&joined, payload, sizeof(joined));
+                    bot.seat = joined.seat;
+                } else if (type == MsgType::Turn && size == sizeof(TurnMsg)) {
+                    TurnMsg turn;
+                    std::memcpy(&turn, payload, sizeof(turn));
+                    answered(bot);
+                    if (turn.seat == bot.seat) {
+                        int32_t value = turn.lowerBound + (turn.upperBound - turn.lowerBound) / 2;
+                        if (options.thinkMs > 0) {
+                            bot.guess = value;
+                            thinking.push_back({Clock::now() + std::chrono::milliseconds(options.thinkMs),
+                                static_cast<size_t>(&bot - bots.data())});
+                        } else {
+                            sendGuess(bot, value);
+                        }
+                    }
+                } else if (type == MsgType::GameOver) {
+                    if (bot.seat == 0) {
+                        stats.games++;
+                    }
+                    answered(bot);
+                } else if (type == MsgType::Error) {
+                    stats.errors++;
+                }
+                return true;
+            });
+        }
+        auto now = Clock::now();
+        while (!thinking.empty() && thinking.front().due <= now) {
+            Bot& bot = bots[thinking.front().bot];
+            sendGuess(bot, bot.guess);
+            thinking.pop_front();
+        }
+    }
+
+    for (Bot& bot : bots) {
+        if (bot.fd >= 0) {
+            ::close(bot.fd);
+        }
+    }
+    ::close(epollFd);
+}
+
+static bool queryStats(const LoadOptions& options, StatsMsg& stats) {
+    int fd = connectTcp(options.host, options.port);
+    if (fd < 0) {
+        return false;
+    }
+    WireBuffer wire;
+    appendMessage(wire, MsgType::StatsRequest, nullptr, 0);
+    bool received = false;
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (flushOut(fd, wire) && !received && Clock::now() < deadline) {
+        if (!readAvailable(fd, wire)) {
+            break;
+        }
+        drainMessages(wire, [&](MsgType type, const uint8_t* payload, size_t size) {
+            if (type == MsgType::Stats && size == sizeof(StatsMsg)) {
+                std::memcpy(&stats, payload, sizeof(stats));
+                received = true;
+            }
+            return !received;
+        });
+        if (!received) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    ::close(fd);
+    return received;
+}
+
+static uint64_t percentile(const std::vector<uint64_t>& histogram, uint64_t total, double fraction) {
+    uint64_t wanted = static_cast<uint64_t>(total * fraction);
+    uint64_t seen = 0;
+    for (size_t us = 0; us < histogram.size(); us++) {
+        seen += histogram[us];
+        if (seen > wanted) {
+            return us;
+        }
+    }
+    return histogram.size() - 1;
+}
+
+static void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "Uso: %s [--host IP] [--port N] [--rooms N] [--players N] [--threads N] [--seconds N] [--think-ms N] [--first-room N]\n",
+        program);
+}
+
+int main(int argc, char** argv) {
+    LoadOptions options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (std::strcmp(arg, "--host") == 0) {
+            options.host = value;
+        } else if (std::strcmp(arg, "--port") == 0) {
+            options.port = static_cast<uint16_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--rooms") == 0) {
+            options.rooms = std::atoi(value);
+        } else if (std::strcmp(arg, "--players") == 0) {
+            options.players = std::atoi(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--seconds") == 0) {
+            options.seconds = std::atof(value);
+        } else if (std::strcmp(arg, "--think-ms") == 0) {
+            options.thinkMs = std::atoi(value);
+        } else if (std::strcmp(arg, "--first-room") == 0) {
+            options.firstRoom = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (options.rooms <= 0 || options.players <= 0 || options.players > 255 || options.threads <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    options.threads = std::min(options.threads, options.rooms);
+
+    StatsMsg before = {};
+    if (!queryStats(options, before)) {
+        std::fprintf(stderr, "Servidor %s:%u nao respondeu\n", options.host, options.port);
+        return 1;
+    }
+
+    std::vector<LoadStats> perThread(options.threads);
+    std::vector<std::thread> workers;
+    uint32_t nextRoom = options.firstRoom;
+    for (int t = 0; t < options.threads; t++) {
+        int share = options.rooms / options.threads + (t < options.rooms % options.threads ? 1 : 0);
+        workers.emplace_back([&options, &perThread, nextRoom, share, t]() {
+            runBots(options, nextRoom, share, perThread[t]);
+        });
+        nextRoom += static_cast<uint32_t>(share);
+    }
+    // Let every table fill before the measured window starts.
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    StatsMsg start = {};
+    queryStats(options, start);
+    auto startedAt = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    StatsMsg end = {};
+    queryStats(options, end);
+    double seconds = std::chrono::duration<double>(Clock::now() - startedAt).count();
+    stopping.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    LoadStats total;
+    total.latency.assign(latencyBuckets, 0);
+    for (const auto& stats : perThread) {
+        total.turns += stats.turns;
+        total.games += stats.games;
+        total.errors += stats.errors;
+        total.maxLatencyUs = std::max(total.maxLatencyUs, stats.maxLatencyUs);
+        for (size_t us = 0; us < latencyBuckets; us++) {
+            total.latency[us] += stats.latency[us];
+        }
+    }
+
+    double serverCores = (end.cpuMicros - start.cpuMicros) / 1e6 / seconds;
+    double serverTurns = static_cast<double>(end.turns - start.turns);
+    std::printf("salas: %d  jogadores: %d  threads: %d  pensar: %d ms\n",
+        options.rooms, options.players, options.threads, options.thinkMs);
+    std::printf("turnos: %llu  jogos: %llu  erros: %llu\n", static_cast<unsigned long long>(total.turns),
+        static_cast<unsigned long long>(total.games), static_cast<unsigned long long>(total.errors));
+    std::printf("latencia por jogada (us): p50 %llu  p90 %llu  p99 %llu  max %llu\n",
+        static_cast<unsigned long long>(percentile(total.latency, total.turns, 0.50)),
+        static_cast<unsigned long long>(percentile(total.latency, total.turns, 0.90)),
+        static_cast<unsigned long long>(percentile(total.latency, total.turns, 0.99)),
+        static_cast<unsigned long long>(total.maxLatencyUs));
+    std::printf("servidor: %.0f turnos/s  cpu %.1f%%  %u salas\n", serverTurns / seconds, serverCores * 100.0, end.rooms);
+    std::printf("salas por nucleo: %.0f  turnos por segundo de cpu: %.0f\n",
+        serverCores > 0.0 ? end.rooms / serverCores : 0.0,
+        serverCores > 0.0 ? serverTurns / (serverCores * seconds) : 0.0);
+    return total.errors > 0 ? 1 : 0;
+}
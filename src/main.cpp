@@ -1,426 +1,779 @@
 #include <raylib.h>
+#include <rlgl.h>
 #include <string>
 #include <vector>
 #include <random>
 #include <algorithm>
-#include <fstream>
-#include <map>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include "app.h"
+#include "assets.h"
+#include "dice_strip.h"
+#include "event_log.h"
+#include "game.h"
+#include "glyph_cache.h"
+#include "input_log.h"
+#include "music_streamer.h"
+#include "rng.h"
+#include "score_writer.h"
+#include "leaderboard.h"
+#include "text_cache.h"
+#include "profiler.h"
+#ifdef DICE_ALLOC_HOOK
+#include "alloc_counter.h"
 
-struct Player {
-    std::string name;
-    int tries;
-    int bestScore;
+// Frames without input or a guess must not touch the heap once startup
+// is over; a build with the hook exits with an error when one does.
+const int allocWarmupFrames = 120;
+#endif
+
+// Also the point where labels claim their glyphs, so anything outside the
+// baked ASCII set is rasterized before it is measured or drawn.
+const TextLabel& measureLabel(TextLabel& label, GlyphCache& glyphs, float fontSize, float spacing) {
+    glyphs.require(label.c_str());
+    if (label.needsMeasure(fontSize, spacing)) {
+        Vector2 size = MeasureTextEx(glyphs.font(), label.c_str(), fontSize, spacing);
+        label.setMeasured(fontSize, spacing, size.x, size.y);
+    }
+    return label;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Share of one core, as CPU seconds spent per minute of wall time.
+static double cpuSecondsPerMinute(uint64_t cpuNs, uint64_t wallNs) {
+    return wallNs > 0 ? 60.0 * static_cast<double>(cpuNs) / static_cast<double>(wallNs) : 0.0;
+}
+
+struct KeyBinding {
+    int raylibKey;
+    InputKey key;
 };
 
-struct ScoreEntry {
-    std::string name;
-    int bestScore;
-    int gamesPlayed;
+static const KeyBinding keyBindings[] = {
+    {KEY_ENTER, KeyEnter}, {KEY_TAB, KeyTab}, {KEY_BACKSPACE, KeyBackspace},
+    {KEY_UP, KeyUp}, {KEY_DOWN, KeyDown}, {KEY_PAGE_UP, KeyPageUp}, {KEY_PAGE_DOWN, KeyPageDown},
+    {KEY_HOME, KeyHome}, {KEY_END, KeyEnd}, {KEY_LEFT, KeyLeft}, {KEY_RIGHT, KeyRight},
+    {KEY_F3, KeyF3}, {KEY_F4, KeyF4}
 };
 
-std::map<std::string, ScoreEntry> loadScoreboard() {
-    std::map<std::string, ScoreEntry> scoreboard;
-    std::ifstream file("scoreboard.txt");
-    std::string line;
-    
-    while (std::getline(file, line)) {
-        size_t pos = line.find(',');
-        if (pos != std::string::npos) {
-            std::string name = line.substr(0, pos);
-            size_t pos2 = line.find(',', pos + 1);
-            if (pos2 != std::string::npos) {
-                int bestScore = std::stoi(line.substr(pos + 1, pos2 - pos - 1));
-                int gamesPlayed = std::stoi(line.substr(pos2 + 1));
-                scoreboard[name] = {name, bestScore, gamesPlayed};
-            }
+FrameInput pollInput() {
+    FrameInput input;
+    // Whole pixels, as the input log stores them, so a replay hits the
+    // same scrubber value the live frame did.
+    Vector2 mouse = GetMousePosition();
+    input.mouseX = std::round(mouse.x);
+    input.mouseY = std::round(mouse.y);
+    input.mousePressed = IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+    for (const KeyBinding& binding : keyBindings) {
+        if (IsKeyPressed(binding.raylibKey)) {
+            input.keys |= binding.key;
+        }
+    }
+    input.wheel = static_cast<int>(GetMouseWheelMove());
+    int key = GetCharPressed();
+    while (key > 0) {
+        if (input.charCount < FrameInput::maxChars) {
+            input.chars[input.charCount++] = key;
         }
+        key = GetCharPressed();
     }
-    return scoreboard;
+    return input;
 }
 
-void saveScoreboard(const std::map<std::string, ScoreEntry>& scoreboard) {
-    std::ofstream file("scoreboard.txt");
-    for (const auto& entry : scoreboard) {
-        file << entry.second.name << "," << entry.second.bestScore << "," << entry.second.gamesPlayed << "\n";
+// Replays go to a scratch scoreboard so they never touch the kiosk's.
+const char* replayScoreboardPath = "scoreboard.replay.bin";
+
+// Runs a recorded session without a window or frame cap and reports the
+// simulated frame rate. With DICE_ALLOC_HOOK it is also the allocation
+// check: it fails if a steady frame of the replay allocated.
+int runHeadlessReplay(InputReplay& replay, const ScoreWriterOptions& scoreOptions) {
+    std::remove(replayScoreboardPath);
+    Leaderboard leaderboard;
+    // Without a frame cap games end far faster than the writer's batches.
+    ScoreWriter scores(1 << 16);
+    if (!scores.open(replayScoreboardPath, scoreOptions, leaderboard)) {
+        std::fprintf(stderr, "Nao foi possivel abrir %s\n", replayScoreboardPath);
+        return 1;
     }
-}
+    Rng rng(replay.seed());
+
+    AppState app;
+    app.leaderboard = &leaderboard;
+    app.scores = &scores;
+    app.rng = &rng;
+    app.diceFaceHeight = replay.diceFaceHeight();
 
-void resetGame(std::vector<Player>& players, int& currentPlayer, int& targetNumber, 
-              std::string& message, std::string& hint, int maxNumber, std::string& currentState,
-              int& lowerBound, int& upperBound) {
-    for (auto& player : players) {
-        player.tries = 0;
+    FrameInput input;
+#ifdef DICE_ALLOC_HOOK
+    int steadyFrames = 0;
+    int allocatingFrames = 0;
+#endif
+    auto start = std::chrono::steady_clock::now();
+    while (replay.next(input)) {
+#ifdef DICE_ALLOC_HOOK
+        uint64_t allocsAtFrameStart = allocationCount();
+        uint64_t guessesAtFrameStart = app.guesses;
+#endif
+        updateApp(app, input);
+#ifdef DICE_ALLOC_HOOK
+        if (replay.framesRead() > static_cast<uint32_t>(allocWarmupFrames) && !input.any() &&
+            app.guesses == guessesAtFrameStart) {
+            steadyFrames++;
+            uint64_t frameAllocs = allocationCount() - allocsAtFrameStart;
+            if (frameAllocs > 0) {
+                allocatingFrames++;
+                std::fprintf(stderr, "AllocHook: quadro %u fez %llu alocacoes\n", replay.framesRead(),
+                    static_cast<unsigned long long>(frameAllocs));
+            }
+        }
+#endif
     }
-    currentPlayer = 0;
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1, maxNumber);
-    targetNumber = dis(gen);
-    message = "Vez de " + players[currentPlayer].name + ". Adivinhe o número (1-" + std::to_string(maxNumber) + "):";
-    hint = "";
-    currentState = "game";
-    lowerBound = 1;
-    upperBound = 6;
+    double seconds = secondsSince(start);
+    uint32_t frames = replay.framesRead();
+    std::printf("Replay: %u de %u quadros em %.3f s (%.0f quadros/s)\n", frames, replay.frameCount(), seconds,
+        seconds > 0.0 ? frames / seconds : 0.0);
+    std::printf("Estado: %s\nMensagem: %s\n", app.currentState.c_str(), app.message.c_str());
+    scores.close();
+#ifdef DICE_ALLOC_HOOK
+    std::printf("AllocHook: %d de %d quadros estaveis alocaram memoria\n", allocatingFrames, steadyFrames);
+    if (allocatingFrames > 0) {
+        return 1;
+    }
+#endif
+    return frames == replay.frameCount() ? 0 : 1;
 }
 
-int main(void) {
+int main(int argc, char** argv) {
+    auto startupBegin = std::chrono::steady_clock::now();
     const int screenWidth = 800;
     const int screenHeight = 600;
 
+    uint64_t seed = 0;
+    bool seeded = false;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    bool headless = false;
+    bool alwaysRedraw = false;
+    ScoreWriterOptions scoreOptions;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+            seeded = true;
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--always-redraw") == 0) {
+            alwaysRedraw = true;
+        } else if (std::strcmp(argv[i], "--fsync") == 0 && i + 1 < argc) {
+            if (!parseFsyncPolicy(argv[++i], scoreOptions.fsync)) {
+                std::fprintf(stderr, "Uso: --fsync never|batch|interval\n");
+                return 1;
+            }
+        }
+    }
+
+    InputReplay replay;
+    if (replayPath != nullptr) {
+        if (!replay.open(replayPath)) {
+            std::fprintf(stderr, "Nao foi possivel ler a gravacao %s\n", replayPath);
+            return 1;
+        }
+        seed = replay.seed();
+        seeded = true;
+    } else if (headless) {
+        std::fprintf(stderr, "Uso: Dinossaurineo --replay <arquivo> --headless\n");
+        return 1;
+    }
+    if (headless) {
+        return runHeadlessReplay(replay, scoreOptions);
+    }
+    if (!seeded) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+    Rng rng(seed);
+
     InitWindow(screenWidth, screenHeight, "Jogo de Dados");
     SetTargetFPS(60);
 
+    TraceLog(LOG_INFO, "RNG: seed %llu", static_cast<unsigned long long>(seed));
+
+    AssetPack pack;
+    GameAssets assets;
+    Leaderboard leaderboard;
+    ScoreWriter scores;
+    EventLogWriter events;
+    std::atomic<bool> assetsReady{false};
+    std::thread loader([&]() {
+        loadGameAssets(pack, "resources/assets.pak", assets);
+        const char* scoreboardPath = replay.isOpen() ? replayScoreboardPath : "scoreboard.bin";
+        if (replay.isOpen()) {
+            std::remove(scoreboardPath);
+        }
+        bool migrate = !replay.isOpen() && !FileExists(scoreboardPath) && FileExists("scoreboard.txt");
+        if (!scores.open(scoreboardPath, scoreOptions, leaderboard, migrate ? "scoreboard.txt" : nullptr)) {
+            TraceLog(LOG_WARNING, "Placar: nao foi possivel abrir %s", scoreboardPath);
+        }
+        // Replays would only repeat guesses already in the log.
+        if (!replay.isOpen() && !events.open("events.bin")) {
+            TraceLog(LOG_WARNING, "Eventos: nao foi possivel abrir events.bin");
+        }
+        assetsReady.store(true, std::memory_order_release);
+    });
+
+    bool firstFrameDrawn = false;
+    while (!assetsReady.load(std::memory_order_acquire) && !WindowShouldClose()) {
+        BeginDrawing();
+        ClearBackground({240, 240, 240, 255});
+        DrawRectangleGradientV(0, 0, screenWidth, 120, {39, 174, 96, 255}, {52, 152, 219, 255});
+        DrawText("Carregando...", screenWidth / 2 - MeasureText("Carregando...", 30) / 2, screenHeight / 2 - 15, 30, {44, 62, 80, 255});
+        EndDrawing();
+        if (!firstFrameDrawn) {
+            firstFrameDrawn = true;
+            TraceLog(LOG_INFO, "Startup: primeiro quadro em %.1f ms", secondsSince(startupBegin) * 1000.0);
+        }
+    }
+    loader.join();
+    TraceLog(LOG_INFO, "Startup: assets %s", assets.fromPack ? "do pacote" : "de resources/");
+
     InitAudioDevice();
-    Music bgm = LoadMusicStream("resources/music.mp3");
-    PlayMusicStream(bgm);
-
-    std::vector<Player> players;
-    int currentPlayer = 0;
-    int targetNumber = 0;
-    bool gameStarted = false;
-    bool waitingForGuess = false;
-    std::string inputText = "";
-    std::string message = "Digite o número de jogadores:";
-    std::string currentState = "setup";
-    std::string hint = "";
-    int maxNumber = 6;
-    bool showScoreboard = false;
-    
-    float titleScale = 1.0f;
-    float titleScaleDirection = 0.002f;
-    Color titleColor = {39, 174, 96, 255};
-    float messageOpacity = 1.0f;
-    float messageOpacityDirection = -0.01f;
-
-    Font gameFont = LoadFontEx("resources/font.ttf", 32, 0, 0);
-    if (gameFont.texture.id == 0) {
-        gameFont = GetFontDefault();
+    MusicStreamer music;
+    if (!music.start(assets.music, assets.musicSize)) {
+        TraceLog(LOG_WARNING, "Audio: nao foi possivel tocar a musica");
+    }
+
+    AppState app;
+    app.leaderboard = &leaderboard;
+    app.rng = &rng;
+    if (scores.isOpen()) {
+        app.scores = &scores;
+    }
+    if (events.isOpen()) {
+        app.events = &events;
+    }
+    GameSession& session = app.session;
+    std::vector<Player>& players = session.players;
+    const int& currentPlayer = session.currentPlayer;
+    const std::string& currentState = app.currentState;
+
+    GlyphCache glyphCache;
+    glyphCache.init(assets);
+    Font& gameFont = glyphCache.font();
+
+    Texture2D diceSheet = uploadDiceTexture(assets);
+    const int diceFaceSize = AppState::diceFaceSize;
+    const int diceStartX = AppState::diceStartX;
+    const int diceY = AppState::diceY;
+    app.diceFaceHeight = replay.isOpen() ? replay.diceFaceHeight() : diceSheet.height * diceFaceSize / (diceSheet.width / AppState::diceSheetFaces);
+    const int visibleRows = AppState::visibleRows;
+    DiceStrip diceStrip;
+    Color dieTints[AppState::diceSheetFaces];
+
+    InputRecorder recorder;
+    if (recordPath != nullptr && !recorder.open(recordPath, seed, app.diceFaceHeight)) {
+        TraceLog(LOG_WARNING, "Gravacao: nao foi possivel criar %s", recordPath);
     }
 
-    Texture2D diceSheet = LoadTexture("resources/clipart1023082.png");
-    int diceAreaWidth = 600;
-    int diceFaceSize = diceAreaWidth / 6;
-    int diceFaceHeight = diceSheet.height * diceFaceSize / (diceSheet.width / 6);
-    int diceStartX = (screenWidth - diceAreaWidth) / 2;
-    int diceY = 450;
-    int selectedDice[2] = {-1, -1};
-    int numSelected = 0;
-    bool guessMade = false;
-    bool guessCorrect = false;
-    bool showHint = false;
-    std::string lastHint = "";
+    TextLabel titleLabel, messageLabel, hintLabel, inputLabel, buttonLabel;
+    TextLabel scoreboardTitleLabel, scoreboardHintLabel, scoreboardRangeLabel;
+    TextLabel scrubberLowLabel, scrubberHighLabel, scrubberHoverLabel, scrubberHintLabel;
+    std::vector<TextLabel> playerLabels;
+    std::vector<TextLabel> scoreLabels(visibleRows);
+    titleLabel.assign("Jogo de Dados");
+    buttonLabel.assign("Jogar Novamente");
+    scoreboardHintLabel.assign("TAB fechar  <- -> ordem  END minha posição");
 
-    int lowerBound = 1;
-    int upperBound = 6;
+    static Profiler profiler;
+    bool showProfiler = false;
+    ProfileSummary profileSummary = {};
+    TextLabel profilerLabels[static_cast<size_t>(ProfilePhase::Count) + 5];
+    MusicStats musicStats = {};
+
+    // The panels are rendered into panelLayer only when they change and
+    // composited over the animated title and message every frame. After
+    // idleAfterFrames without input the frame rate drops to idleFps.
+    // --always-redraw turns both off for comparison.
+    const bool cachedRendering = !alwaysRedraw;
+    const bool pacing = !alwaysRedraw;
+    const int activeFps = 60;
+    const int idleFps = 15;
+    const int idleAfterFrames = 180;
+    RenderTexture2D panelLayer = {};
+    if (cachedRendering) {
+        panelLayer = LoadRenderTexture(screenWidth, screenHeight);
+    }
+    bool panelsDirty = true;
+    uint64_t panelRedraws = 0;
+    int framesSinceActivity = 0;
+    bool idle = false;
+    float lastMouseX = -1.0f;
+    float lastMouseY = -1.0f;
+    uint64_t cpuIdleNs = 0, wallIdleNs = 0, cpuActiveNs = 0, wallActiveNs = 0;
+    uint64_t lastCpu = Profiler::cpuNow();
+    uint64_t lastWall = Profiler::now();
 
-    auto scoreboard = loadScoreboard();
+#ifdef DICE_ALLOC_HOOK
+    int frameCount = 0;
+    int steadyFrames = 0;
+    int allocatingFrames = 0;
+#endif
+
+    TraceLog(LOG_INFO, "Startup: interativo em %.1f ms", secondsSince(startupBegin) * 1000.0);
 
     while(!WindowShouldClose()) {
-        UpdateMusicStream(bgm);
+        FrameInput input = pollInput();
+        if (replay.isOpen() && !replay.next(input)) {
+            TraceLog(LOG_INFO, "Replay: fim da gravacao apos %u quadros", replay.framesRead());
+            break;
+        }
+        recorder.write(input);
+#ifdef DICE_ALLOC_HOOK
+        uint64_t allocsAtFrameStart = allocationCount();
+        bool inputThisFrame = input.any();
+#endif
+        uint64_t guessesAtFrameStart = app.guesses;
+        glyphCache.nextFrame();
+        ProfileScope frameScope(profiler, ProfilePhase::Frame);
+        ProfileScope phase(profiler, ProfilePhase::Logic);
 
-        titleScale += titleScaleDirection;
-        if (titleScale > 1.05f || titleScale < 0.95f) {
-            titleScaleDirection *= -1;
+        updateApp(app, input);
+        // Other kiosks' games reach the board through the score writer.
+        bool boardMerged = scores.applyMerged(leaderboard) > 0;
+
+        if (input.pressed(KeyF3)) {
+            showProfiler = !showProfiler;
+        }
+        if (input.pressed(KeyF4)) {
+            if (profiler.writeChromeTrace("trace.json")) {
+                TraceLog(LOG_INFO, "Profiler: trace.json gravado");
+            } else {
+                TraceLog(LOG_WARNING, "Profiler: nao foi possivel gravar trace.json");
+            }
         }
 
-        messageOpacity += messageOpacityDirection;
-        if (messageOpacity < 0.7f || messageOpacity > 1.0f) {
-            messageOpacityDirection *= -1;
+        // Panels change only with input or a guess; the mouse alone moves
+        // nothing but the hover highlights drawn over them.
+        bool sceneChanged = input.any() || app.guesses != guessesAtFrameStart || boardMerged;
+        bool mouseMoved = input.mouseX != lastMouseX || input.mouseY != lastMouseY;
+        lastMouseX = input.mouseX;
+        lastMouseY = input.mouseY;
+        panelsDirty = panelsDirty || sceneChanged;
+        if (sceneChanged || mouseMoved || app.botTurn()) {
+            framesSinceActivity = 0;
+        } else if (framesSinceActivity < idleAfterFrames) {
+            framesSinceActivity++;
+        }
+        bool nowIdle = pacing && framesSinceActivity >= idleAfterFrames;
+        if (nowIdle != idle) {
+            idle = nowIdle;
+            SetTargetFPS(idle ? idleFps : activeFps);
+            app.animationSteps = idle ? activeFps / idleFps : 1;
         }
 
-        if (currentState == "game") {
-            Vector2 mouse = GetMousePosition();
-            for (int i = 0; i < 6; i++) {
-                Rectangle dieRect = {
-                    (float)(diceStartX + i * diceFaceSize),
-                    (float)diceY,
-                    (float)diceFaceSize,
-                    (float)diceFaceHeight
-                };
-                if (CheckCollisionPointRec(mouse, dieRect) && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                    selectedDice[0] = i;
-                    numSelected = 1;
-                    guessMade = true;
-                }
+        // Everything below the title and message: it only changes on input
+        // or a guess, so the cached path renders it into panelLayer once
+        // per change instead of every frame. Split in three so the
+        // always-redraw path can time each part as its own phase.
+        auto drawPanelText = [&]() {
+            if (!app.hint.empty()) {
+                hintLabel.assign(app.hint.c_str());
+                measureLabel(hintLabel, glyphCache, 25, 2);
+                DrawTextEx(gameFont, hintLabel.c_str(), 
+                    {(screenWidth - hintLabel.width()) / 2, 180}, 
+                    25, 2, {231, 76, 60, 255});
             }
-            // Handle guess
-            if (guessMade) {
-                int guess = selectedDice[0] + 1;
-                players[currentPlayer].tries++;
-                if (guess == targetNumber) {
-                    guessCorrect = true;
-                    currentPlayer++;
-                    if (currentPlayer >= players.size()) {
-                        currentState = "end";
-                        auto minTries = std::min_element(players.begin(), players.end(),
-                            [](const Player& a, const Player& b) { return a.tries < b.tries; });
-                        int minTriesValue = minTries->tries;
-                        int winners = std::count_if(players.begin(), players.end(),
-                            [minTriesValue](const Player& p) { return p.tries == minTriesValue; });
-                        if (winners > 1) {
-                            message = "Empate! Múltiplos jogadores com " + std::to_string(minTriesValue) + " tentativas!";
+        
+            if (currentState != "game" || app.usesScrubber()) {
+                int inputBoxWidth = 300;
+                int inputBoxX = (screenWidth - inputBoxWidth) / 2;
+                DrawRectangle(inputBoxX, 220, inputBoxWidth, 50, {230, 230, 230, 255});
+                DrawRectangleLines(inputBoxX, 220, inputBoxWidth, 50, {200, 200, 200, 255});
+                inputLabel.assign(app.inputText.c_str());
+                measureLabel(inputLabel, glyphCache, 30, 2);
+                DrawTextEx(gameFont, inputLabel.c_str(), 
+                    {inputBoxX + (inputBoxWidth - inputLabel.width()) / 2, 230}, 
+                    30, 2, BLACK);
+            }
+        
+            if (currentState == "game" || currentState == "end") {
+                int playerBoxWidth = 400;
+                int playerBoxX = (screenWidth - playerBoxWidth) / 2;
+                int playerBoxHeight = static_cast<int>(players.size() * 50 + 20);
+                DrawRectangle(playerBoxX, 290, playerBoxWidth, playerBoxHeight, {245, 245, 245, 255});
+                DrawRectangleLines(playerBoxX, 290, playerBoxWidth, playerBoxHeight, {220, 220, 220, 255});
+            
+                if (playerLabels.size() != players.size()) {
+                    playerLabels.resize(players.size());
+                }
+                for (size_t i = 0; i < players.size(); i++) {
+                    const Player& player = players[i];
+                    uint64_t key = labelKey(labelKey(labelKey(0, player.name.data(), player.name.size()),
+                        static_cast<uint64_t>(player.bestScore)), static_cast<uint64_t>(player.tries));
+                    TextLabel& playerLabel = playerLabels[i];
+                    if (playerLabel.stale(key)) {
+                        if (player.bestScore > 0) {
+                            playerLabel.format(key, "%s (Melhor: %d): %d tentativas", player.name.c_str(), player.bestScore, player.tries);
                         } else {
-                            message = minTries->name + " venceu com " + std::to_string(minTriesValue) + " tentativas!";
-                        }
-                        for (auto& player : players) {
-                            if (scoreboard.find(player.name) == scoreboard.end()) {
-                                scoreboard[player.name] = {player.name, player.tries, 1};
-                                player.bestScore = player.tries;
-                            } else {
-                                scoreboard[player.name].gamesPlayed++;
-                                if (player.tries < scoreboard[player.name].bestScore || scoreboard[player.name].bestScore == 0) {
-                                    scoreboard[player.name].bestScore = player.tries;
-                                    player.bestScore = player.tries;
-                                }
-                            }
+                            playerLabel.format(key, "%s: %d tentativas", player.name.c_str(), player.tries);
                         }
-                        saveScoreboard(scoreboard);
-                    } else {
-                        std::random_device rd;
-                        std::mt19937 gen(rd());
-                        std::uniform_int_distribution<> dis(1, maxNumber);
-                        targetNumber = dis(gen);
-                        message = "Vez de " + players[currentPlayer].name + ". Adivinhe o número (1-" + std::to_string(maxNumber) + "):";
-                        hint = "";
-                        lowerBound = 1;
-                        upperBound = 6;
-                    }
-                    numSelected = 0;
-                    selectedDice[0] = selectedDice[1] = -1;
-                    guessMade = false;
-                    showHint = false;
-                } else {
-                    guessCorrect = false;
-                    if (guess < targetNumber) {
-                        hint = "Tente um número maior!";
-                        lastHint = "maior";
-                        lowerBound = guess + 1;
-                    } else {
-                        hint = "Tente um número menor!";
-                        lastHint = "menor";
-                        upperBound = guess - 1;
                     }
-                    showHint = true;
-                    guessMade = false;
+                
+                    Color playerColor = (static_cast<int>(i) == currentPlayer && currentState == "game") ? Color{231, 76, 60, 255} : Color{44, 62, 80, 255};
+                    measureLabel(playerLabel, glyphCache, 25, 2);
+                    float yPos = 300.0f + (static_cast<float>(i) * 50.0f);
+                    DrawTextEx(gameFont, playerLabel.c_str(), 
+                        {playerBoxX + (playerBoxWidth - playerLabel.width()) / 2, yPos}, 
+                        25, 2, playerColor);
                 }
             }
-        }
 
-        if (IsKeyPressed(KEY_ENTER)) {
-            if (currentState == "setup") {
-                int numPlayers = std::stoi(inputText);
-                for (int i = 0; i < numPlayers; i++) {
-                    players.push_back({"Jogador " + std::to_string(i + 1), 0, 0});
-                }
-                currentState = "name_input";
-                message = "Digite o nome para " + players[currentPlayer].name + ":";
-                inputText = "";
+            if (currentState == "end") {
+                const int buttonWidth = AppState::buttonWidth;
+                const int buttonHeight = AppState::buttonHeight;
+                const int buttonX = AppState::buttonX;
+                const int buttonY = AppState::buttonY;
+            
+                DrawRectangle(buttonX, buttonY, buttonWidth, buttonHeight, {41, 128, 185, 255});
+                DrawRectangleLines(buttonX, buttonY, buttonWidth, buttonHeight, {220, 220, 220, 255});
+            
+                measureLabel(buttonLabel, glyphCache, 25, 2);
+                DrawTextEx(gameFont, buttonLabel.c_str(),
+                    {buttonX + (buttonWidth - buttonLabel.width()) / 2,
+                     buttonY + (buttonHeight - buttonLabel.height()) / 2},
+                    25, 2, WHITE);
             }
-            else if (currentState == "name_input") {
-                if (!inputText.empty()) {
-                    players[currentPlayer].name = inputText;
-                    if (scoreboard.find(inputText) != scoreboard.end()) {
-                        players[currentPlayer].bestScore = scoreboard[inputText].bestScore;
-                    }
-                    currentPlayer++;
-                    if (currentPlayer >= players.size()) {
-                        currentState = "game";
-                        currentPlayer = 0;
-                        std::random_device rd;
-                        std::mt19937 gen(rd());
-                        std::uniform_int_distribution<> dis(1, maxNumber);
-                        targetNumber = dis(gen);
-                        message = "Vez de " + players[currentPlayer].name + ". Adivinhe o número (1-" + std::to_string(maxNumber) + "):";
-                        hint = "";
-                        lowerBound = 1;
-                        upperBound = maxNumber;
-                    } else {
-                        message = "Digite o nome para " + players[currentPlayer].name + ":";
+        };
+
+        auto drawDice = [&]() {
+            // Draw dice selection UI
+            if (currentState == "game" && !app.usesScrubber()) {
+                diceStrip.layout(diceSheet, AppState::diceSheetFaces, session.maxNumber,
+                    static_cast<float>(app.diceRowStartX()), static_cast<float>(diceY),
+                    static_cast<float>(diceFaceSize), static_cast<float>(app.diceFaceHeight));
+                for (int i = 0; i < diceStrip.faces(); i++) {
+                    int dieValue = i + 1;
+                    Color dieColor = WHITE;
+                    if (dieValue == app.selectedValue) {
+                        dieColor = app.guessCorrect ? GREEN : RED;
+                    } else if (!session.inWindow(dieValue)) {
+                        dieColor = GRAY;
                     }
-                    inputText = "";
+                    dieTints[i] = dieColor;
+                }
+                diceStrip.draw(diceSheet, dieTints);
+            } else if (currentState == "game") {
+                // Range scrubber: the bar spans the open window, so every click
+                // zooms in on what is left.
+                const float barX = static_cast<float>(diceStartX);
+                const float barY = static_cast<float>(diceY);
+                const float barWidth = static_cast<float>(AppState::diceAreaWidth);
+                const float barHeight = static_cast<float>(AppState::scrubberHeight);
+                int lower = session.lowerBound;
+                int upper = session.upperBound;
+                DrawRectangle(diceStartX, diceY, AppState::diceAreaWidth, AppState::scrubberHeight, {230, 230, 230, 255});
+                DrawRectangleLines(diceStartX, diceY, AppState::diceAreaWidth, AppState::scrubberHeight, {200, 200, 200, 255});
+
+                if (scrubberLowLabel.stale(static_cast<uint64_t>(lower))) {
+                    scrubberLowLabel.format(static_cast<uint64_t>(lower), "%d", lower);
+                }
+                if (scrubberHighLabel.stale(static_cast<uint64_t>(upper))) {
+                    scrubberHighLabel.format(static_cast<uint64_t>(upper), "%d", upper);
+                }
+                measureLabel(scrubberHighLabel, glyphCache, 20, 2);
+                DrawTextEx(gameFont, scrubberLowLabel.c_str(), {barX, barY + barHeight + 5.0f}, 20, 2, {44, 62, 80, 255});
+                DrawTextEx(gameFont, scrubberHighLabel.c_str(), {barX + barWidth - scrubberHighLabel.width(), barY + barHeight + 5.0f}, 20, 2, {44, 62, 80, 255});
+
+                uint64_t windowKey = labelKey(static_cast<uint64_t>(lower), static_cast<uint64_t>(upper));
+                if (scrubberHintLabel.stale(windowKey)) {
+                    scrubberHintLabel.format(windowKey, "Ideal: %d (%.2f tentativas esperadas)",
+                        app.strategy.bestGuess(lower, upper), app.strategy.expectedTries(lower, upper));
                 }
+                measureLabel(scrubberHintLabel, glyphCache, 20, 2);
+                DrawTextEx(gameFont, scrubberHintLabel.c_str(),
+                    {(screenWidth - scrubberHintLabel.width()) / 2, barY + barHeight + 5.0f}, 20, 2, {128, 128, 128, 255});
             }
-        }
+        };
 
-        if (IsKeyPressed(KEY_TAB)) {
-            showScoreboard = !showScoreboard;
-        }
+        auto drawScoreboard = [&]() {
+            if (app.showScoreboard) {
+                const int scrollTop = app.scrollTop;
+                const RankOrder rankOrder = app.rankOrder;
+                int total = static_cast<int>(leaderboard.size());
+                int rows = std::min(total - scrollTop, visibleRows);
+                int myId = app.focusedScoreId();
+                float scoreboardWidth = 520.0f;
+                float scoreboardX = (screenWidth - scoreboardWidth) / 2.0f;
+                float scoreboardHeight = static_cast<float>(visibleRows * 40 + 90);
+                float scoreboardY = (screenHeight - scoreboardHeight) / 2.0f;
+
+                DrawRectangle(0, 0, screenWidth, screenHeight, {0, 0, 0, 200});
+                DrawRectangle(static_cast<int>(scoreboardX), static_cast<int>(scoreboardY), 
+                    static_cast<int>(scoreboardWidth), static_cast<int>(scoreboardHeight), {245, 245, 245, 255});
+                DrawRectangleLines(static_cast<int>(scoreboardX), static_cast<int>(scoreboardY), 
+                    static_cast<int>(scoreboardWidth), static_cast<int>(scoreboardHeight), {220, 220, 220, 255});
+
+                scoreboardTitleLabel.assign(rankOrder == RankOrder::BestScore ? "Placar - Melhor" : "Placar - Jogos");
+                measureLabel(scoreboardTitleLabel, glyphCache, 30, 2);
+                DrawTextEx(gameFont, scoreboardTitleLabel.c_str(), 
+                    {scoreboardX + (scoreboardWidth - scoreboardTitleLabel.width()) / 2.0f, scoreboardY + 10.0f}, 
+                    30, 2, {44, 62, 80, 255});
 
-        int key = GetCharPressed();
-        while (key > 0) {
-            if (currentState == "game") {
-                if ((key >= 48) && (key <= 57) && inputText.length() < 2) {
-                    inputText += (char)key;
+                uint64_t rangeKey = labelKey(labelKey(0, static_cast<uint64_t>(scrollTop)), static_cast<uint64_t>(total));
+                if (scoreboardRangeLabel.stale(rangeKey)) {
+                    scoreboardRangeLabel.format(rangeKey, "%d-%d de %d", total > 0 ? scrollTop + 1 : 0, scrollTop + rows, total);
                 }
-            } else {
-                if ((key >= 32) && (key <= 125) && inputText.length() < 20) {
-                    inputText += (char)key;
+                measureLabel(scoreboardRangeLabel, glyphCache, 20, 2);
+                DrawTextEx(gameFont, scoreboardRangeLabel.c_str(), 
+                    {scoreboardX + scoreboardWidth - scoreboardRangeLabel.width() - 10.0f, scoreboardY + 50.0f}, 
+                    20, 2, {128, 128, 128, 255});
+
+                float y = scoreboardY + 80.0f;
+                for (int row = 0; row < rows; row++) {
+                    uint32_t rank = static_cast<uint32_t>(scrollTop + row);
+                    uint32_t id = leaderboard.at(rank, rankOrder);
+                    const ScoreEntry& entry = leaderboard.entry(id);
+                    uint64_t key = labelKey(labelKey(labelKey(labelKey(0, rank), id),
+                        static_cast<uint64_t>(entry.bestScore)), static_cast<uint64_t>(entry.gamesPlayed));
+                    TextLabel& rowLabel = scoreLabels[row];
+                    if (rowLabel.stale(key)) {
+                        rowLabel.format(key, "%u. %s - Melhor: %d (Jogos: %d)", rank + 1, entry.name.c_str(), entry.bestScore, entry.gamesPlayed);
+                    }
+                    glyphCache.require(rowLabel.c_str());
+                    Color rowColor = static_cast<int>(id) == myId ? Color{231, 76, 60, 255} : Color{44, 62, 80, 255};
+                    DrawTextEx(gameFont, rowLabel.c_str(), {scoreboardX + 20.0f, y}, 20, 2, rowColor);
+                    y += 40.0f;
                 }
-            }
-            key = GetCharPressed();
-        }
 
-        if (IsKeyPressed(KEY_BACKSPACE)) {
-            if (!inputText.empty()) {
-                inputText.pop_back();
+                measureLabel(scoreboardHintLabel, glyphCache, 20, 2);
+                DrawTextEx(gameFont, scoreboardHintLabel.c_str(), 
+                    {scoreboardX + (scoreboardWidth - scoreboardHintLabel.width()) / 2.0f, scoreboardY + scoreboardHeight - 30.0f}, 
+                    20, 2, {128, 128, 128, 255});
             }
+        };
+
+        if (cachedRendering && panelsDirty) {
+            phase.next(ProfilePhase::Panels);
+            BeginTextureMode(panelLayer);
+            ClearBackground(BLANK);
+            // Keep the layer's alpha coverage exact so it can be composited
+            // premultiplied over the title and message.
+            rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+            BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+            drawPanelText();
+            drawDice();
+            drawScoreboard();
+            EndBlendMode();
+            EndTextureMode();
+            panelsDirty = false;
+            panelRedraws++;
         }
 
+        phase.next(ProfilePhase::Text);
+
         BeginDrawing();
         ClearBackground({240, 240, 240, 255});
         
         DrawRectangleGradientV(0, 0, screenWidth, 120, {39, 174, 96, 255}, {52, 152, 219, 255});
         
-        const char* title = "Jogo de Dados";
-        Vector2 titleSize = MeasureTextEx(gameFont, title, 40 * titleScale, 2);
-        DrawTextEx(gameFont, title, 
-            {(screenWidth - titleSize.x) / 2, 40}, 
-            40 * titleScale, 2, WHITE);
-
-        Color messageColor = {0, 0, 0, (unsigned char)(255 * messageOpacity)};
-        Vector2 messageSize = MeasureTextEx(gameFont, message.c_str(), 30, 2);
-        DrawTextEx(gameFont, message.c_str(), 
-            {(screenWidth - messageSize.x) / 2, 140}, 
+        float titleWidth = measureLabel(titleLabel, glyphCache, 40, 2).scaledWidth(app.titleScale);
+        DrawTextEx(gameFont, titleLabel.c_str(), 
+            {(screenWidth - titleWidth) / 2, 40}, 
+            40 * app.titleScale, 2, WHITE);
+
+        Color messageColor = {0, 0, 0, (unsigned char)(255 * app.messageOpacity)};
+        messageLabel.assign(app.message.c_str());
+        measureLabel(messageLabel, glyphCache, 30, 2);
+        DrawTextEx(gameFont, messageLabel.c_str(), 
+            {(screenWidth - messageLabel.width()) / 2, 140}, 
             30, 2, messageColor);
-        
-        if (!hint.empty()) {
-            Vector2 hintSize = MeasureTextEx(gameFont, hint.c_str(), 25, 2);
-            DrawTextEx(gameFont, hint.c_str(), 
-                {(screenWidth - hintSize.x) / 2, 180}, 
-                25, 2, {231, 76, 60, 255});
-        }
-        
-        if (currentState != "game") {
-            int inputBoxWidth = 300;
-            int inputBoxX = (screenWidth - inputBoxWidth) / 2;
-            DrawRectangle(inputBoxX, 220, inputBoxWidth, 50, {230, 230, 230, 255});
-            DrawRectangleLines(inputBoxX, 220, inputBoxWidth, 50, {200, 200, 200, 255});
-            Vector2 inputTextSize = MeasureTextEx(gameFont, inputText.c_str(), 30, 2);
-            DrawTextEx(gameFont, inputText.c_str(), 
-                {inputBoxX + (inputBoxWidth - inputTextSize.x) / 2, 230}, 
-                30, 2, BLACK);
-        }
-        
-        if (currentState == "game" || currentState == "end") {
-            int playerBoxWidth = 400;
-            int playerBoxX = (screenWidth - playerBoxWidth) / 2;
-            int playerBoxHeight = static_cast<int>(players.size() * 50 + 20);
-            DrawRectangle(playerBoxX, 290, playerBoxWidth, playerBoxHeight, {245, 245, 245, 255});
-            DrawRectangleLines(playerBoxX, 290, playerBoxWidth, playerBoxHeight, {220, 220, 220, 255});
-            
-            for (size_t i = 0; i < players.size(); i++) {
-                std::string playerInfo = players[i].name;
-                if (players[i].bestScore > 0) {
-                    playerInfo += " (Melhor: " + std::to_string(players[i].bestScore) + ")";
-                }
-                playerInfo += ": " + std::to_string(players[i].tries) + " tentativas";
-                
-                Color playerColor = (i == currentPlayer && currentState == "game") ? Color{231, 76, 60, 255} : Color{44, 62, 80, 255};
-                Vector2 playerInfoSize = MeasureTextEx(gameFont, playerInfo.c_str(), 25, 2);
-                float yPos = 300.0f + (static_cast<float>(i) * 50.0f);
-                DrawTextEx(gameFont, playerInfo.c_str(), 
-                    {playerBoxX + (playerBoxWidth - playerInfoSize.x) / 2, yPos}, 
-                    25, 2, playerColor);
-            }
+
+        if (cachedRendering) {
+            BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+            DrawTextureRec(panelLayer.texture,
+                {0.0f, 0.0f, static_cast<float>(screenWidth), -static_cast<float>(screenHeight)}, {0.0f, 0.0f}, WHITE);
+            EndBlendMode();
+        } else {
+            drawPanelText();
         }
 
-        if (currentState == "end") {
-            int buttonWidth = 200;
-            int buttonHeight = 50;
-            int buttonX = (screenWidth - buttonWidth) / 2;
-            int buttonY = 400;
-            
-            Rectangle buttonRect = {
-                (float)buttonX,
-                (float)buttonY,
-                (float)buttonWidth,
-                (float)buttonHeight
-            };
-            
-            bool isMouseOverButton = CheckCollisionPointRec(GetMousePosition(), buttonRect);
-            Color buttonColor = isMouseOverButton ? Color{52, 152, 219, 255} : Color{41, 128, 185, 255};
-            
-            DrawRectangle(buttonX, buttonY, buttonWidth, buttonHeight, buttonColor);
-            DrawRectangleLines(buttonX, buttonY, buttonWidth, buttonHeight, {220, 220, 220, 255});
-            
-            const char* buttonText = "Jogar Novamente";
-            Vector2 buttonTextSize = MeasureTextEx(gameFont, buttonText, 25, 2);
-            DrawTextEx(gameFont, buttonText,
-                {buttonX + (buttonWidth - buttonTextSize.x) / 2,
-                 buttonY + (buttonHeight - buttonTextSize.y) / 2},
+        // Hover feedback follows the mouse every frame, on top of the layer.
+        if (!app.showScoreboard && currentState == "end" && app.overButton()) {
+            DrawRectangle(AppState::buttonX, AppState::buttonY, AppState::buttonWidth, AppState::buttonHeight, {52, 152, 219, 255});
+            DrawRectangleLines(AppState::buttonX, AppState::buttonY, AppState::buttonWidth, AppState::buttonHeight, {220, 220, 220, 255});
+            DrawTextEx(gameFont, buttonLabel.c_str(),
+                {AppState::buttonX + (AppState::buttonWidth - buttonLabel.width()) / 2,
+                 AppState::buttonY + (AppState::buttonHeight - buttonLabel.height()) / 2},
                 25, 2, WHITE);
-            
-            if (isMouseOverButton && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                resetGame(players, currentPlayer, targetNumber, message, hint, maxNumber, currentState, lowerBound, upperBound);
-            }
         }
 
-        if (showScoreboard) {
-            float scoreboardWidth = 400.0f;
-            float scoreboardX = (screenWidth - scoreboardWidth) / 2.0f;
-            float scoreboardHeight = static_cast<float>(scoreboard.size() * 40 + 60);
-            float scoreboardY = (screenHeight - scoreboardHeight) / 2.0f;
-
-            DrawRectangle(0, 0, screenWidth, screenHeight, {0, 0, 0, 200});
-            DrawRectangle(static_cast<int>(scoreboardX), static_cast<int>(scoreboardY), 
-                static_cast<int>(scoreboardWidth), static_cast<int>(scoreboardHeight), {245, 245, 245, 255});
-            DrawRectangleLines(static_cast<int>(scoreboardX), static_cast<int>(scoreboardY), 
-                static_cast<int>(scoreboardWidth), static_cast<int>(scoreboardHeight), {220, 220, 220, 255});
-
-            const char* scoreboardTitle = "Placar";
-            Vector2 titleSize = MeasureTextEx(gameFont, scoreboardTitle, 30, 2);
-            DrawTextEx(gameFont, scoreboardTitle, 
-                {scoreboardX + (scoreboardWidth - titleSize.x) / 2.0f, scoreboardY + 10.0f}, 
-                30, 2, {44, 62, 80, 255});
-
-            float y = scoreboardY + 50.0f;
-            for (const auto& entry : scoreboard) {
-                std::string scoreInfo = entry.second.name + " - Melhor: " + 
-                    std::to_string(entry.second.bestScore) + " (Jogos: " + 
-                    std::to_string(entry.second.gamesPlayed) + ")";
-                DrawTextEx(gameFont, scoreInfo.c_str(), {scoreboardX + 20.0f, y}, 20, 2, {44, 62, 80, 255});
-                y += 40.0f;
+        phase.next(ProfilePhase::Dice);
+        if (!cachedRendering) {
+            drawDice();
+        }
+        if (!app.showScoreboard && currentState == "game" && app.usesScrubber()) {
+            int hovered = app.valueAt(app.mouseX, app.mouseY);
+            if (hovered > 0) {
+                const float barX = static_cast<float>(diceStartX);
+                const float barY = static_cast<float>(diceY);
+                const float barWidth = static_cast<float>(AppState::diceAreaWidth);
+                const float barHeight = static_cast<float>(AppState::scrubberHeight);
+                int lower = session.lowerBound;
+                int upper = session.upperBound;
+                float cellWidth = barWidth / (upper - lower + 1);
+                float cellX = barX + (hovered - lower) * cellWidth;
+                DrawRectangleRec({cellX, barY, std::max(cellWidth, 2.0f), barHeight}, {52, 152, 219, 255});
+                if (scrubberHoverLabel.stale(static_cast<uint64_t>(hovered))) {
+                    scrubberHoverLabel.format(static_cast<uint64_t>(hovered), "%d", hovered);
+                }
+                measureLabel(scrubberHoverLabel, glyphCache, 25, 2);
+                float labelX = std::max(barX, std::min(cellX - scrubberHoverLabel.width() / 2, barX + barWidth - scrubberHoverLabel.width()));
+                DrawTextEx(gameFont, scrubberHoverLabel.c_str(), {labelX, barY - 30.0f}, 25, 2, {52, 152, 219, 255});
             }
+        }
 
-            const char* hint = "Pressione TAB para fechar";
-            Vector2 hintSize = MeasureTextEx(gameFont, hint, 20, 2);
-            DrawTextEx(gameFont, hint, 
-                {scoreboardX + (scoreboardWidth - hintSize.x) / 2.0f, scoreboardY + scoreboardHeight - 30.0f}, 
-                20, 2, {128, 128, 128, 255});
+        phase.next(ProfilePhase::Scoreboard);
+        if (!cachedRendering) {
+            drawScoreboard();
         }
         
-        // Draw dice selection UI
-        if (currentState == "game") {
-            for (int i = 0; i < 6; i++) {
-                Rectangle dieRect = {
-                    (float)(diceStartX + i * diceFaceSize),
-                    (float)diceY,
-                    (float)diceFaceSize,
-                    (float)diceFaceHeight
-                };
-                Rectangle srcRect = {
-                    (float)(i * (diceSheet.width / 6)),
-                    0.0f,
-                    (float)(diceSheet.width / 6),
-                    (float)diceSheet.height
-                };
-                int dieValue = i + 1;
-                Color dieColor = WHITE;
-                if (numSelected > 0 && i == selectedDice[0]) {
-                    dieColor = guessCorrect ? GREEN : RED;
-                } else if (dieValue < lowerBound || dieValue > upperBound) {
-                    dieColor = GRAY;
+        if (showProfiler) {
+            if (profiler.frame() % 15 == 0) {
+                profileSummary = profiler.summarize(60);
+                musicStats = music.stats();
+            }
+            const size_t phaseCount = static_cast<size_t>(ProfilePhase::Count);
+            DrawRectangle(10, 10, 300, static_cast<int>(phaseCount + 5) * 20 + 10, {0, 0, 0, 180});
+            for (size_t p = 0; p < phaseCount; p++) {
+                uint64_t key = labelKey(p, static_cast<uint64_t>(profileSummary.phaseMs[p] * 100.0));
+                if (profilerLabels[p].stale(key)) {
+                    profilerLabels[p].format(key, "%-10s %6.2f ms", profilePhaseName(static_cast<ProfilePhase>(p)), profileSummary.phaseMs[p]);
                 }
-                DrawTexturePro(diceSheet, srcRect, dieRect, {0, 0}, 0.0f, dieColor);
+                DrawTextEx(gameFont, profilerLabels[p].c_str(), {20, 15.0f + p * 20.0f}, 18, 1, WHITE);
+            }
+            TextLabel& percentileLabel = profilerLabels[phaseCount];
+            uint64_t key = labelKey(labelKey(phaseCount, static_cast<uint64_t>(profileSummary.frameP50Ms * 100.0)),
+                static_cast<uint64_t>(profileSummary.frameP99Ms * 100.0));
+            if (percentileLabel.stale(key)) {
+                percentileLabel.format(key, "p50 %.2f  p99 %.2f ms", profileSummary.frameP50Ms, profileSummary.frameP99Ms);
+            }
+            DrawTextEx(gameFont, percentileLabel.c_str(), {20, 15.0f + phaseCount * 20.0f}, 18, 1, {241, 196, 15, 255});
+            TextLabel& audioLabel = profilerLabels[phaseCount + 1];
+            uint64_t audioKey = labelKey(labelKey(labelKey(phaseCount + 1, musicStats.underruns),
+                static_cast<uint64_t>(musicStats.decodeAvgUs)), static_cast<uint64_t>(musicStats.decodeMaxUs));
+            if (audioLabel.stale(audioKey)) {
+                audioLabel.format(audioKey, "audio: %llu underruns  dec %.0f/%.0f us",
+                    static_cast<unsigned long long>(musicStats.underruns), musicStats.decodeAvgUs, musicStats.decodeMaxUs);
             }
+            DrawTextEx(gameFont, audioLabel.c_str(), {20, 15.0f + (phaseCount + 1) * 20.0f}, 18, 1, {52, 152, 219, 255});
+            TextLabel& cpuLabel = profilerLabels[phaseCount + 2];
+            double idleCpu = cpuSecondsPerMinute(cpuIdleNs, wallIdleNs);
+            double activeCpu = cpuSecondsPerMinute(cpuActiveNs, wallActiveNs);
+            uint64_t cpuKey = labelKey(labelKey(labelKey(phaseCount + 2, static_cast<uint64_t>(idleCpu * 100.0)),
+                static_cast<uint64_t>(activeCpu * 100.0)), idle ? 1 : 0);
+            if (cpuLabel.stale(cpuKey)) {
+                cpuLabel.format(cpuKey, "cpu/min: ocioso %.2f s  ativo %.2f s%s", idleCpu, activeCpu, idle ? " *" : "");
+            }
+            DrawTextEx(gameFont, cpuLabel.c_str(), {20, 15.0f + (phaseCount + 2) * 20.0f}, 18, 1, {39, 174, 96, 255});
+            TextLabel& glyphLabel = profilerLabels[phaseCount + 3];
+            GlyphCacheStats glyphStats = glyphCache.stats();
+            uint64_t glyphKey = labelKey(labelKey(labelKey(labelKey(phaseCount + 3, static_cast<uint64_t>(glyphStats.resident)),
+                glyphStats.rasterized), glyphStats.evictions), glyphStats.misses);
+            if (glyphLabel.stale(glyphKey)) {
+                glyphLabel.format(glyphKey, "glifos: %d/%d  novos %llu  despejos %llu  faltas %llu", glyphStats.resident,
+                    glyphStats.capacity, static_cast<unsigned long long>(glyphStats.rasterized),
+                    static_cast<unsigned long long>(glyphStats.evictions), static_cast<unsigned long long>(glyphStats.misses));
+            }
+            DrawTextEx(gameFont, glyphLabel.c_str(), {20, 15.0f + (phaseCount + 3) * 20.0f}, 18, 1, {231, 76, 60, 255});
+            TextLabel& scoresLabel = profilerLabels[phaseCount + 4];
+            ScoreWriterStats scoreStats = scores.stats();
+            uint64_t scoresKey = labelKey(labelKey(labelKey(labelKey(phaseCount + 4, scoreStats.queueDepth),
+                scoreStats.batches), scoreStats.maxQueueDepth), scoreStats.dropped);
+            if (scoresLabel.stale(scoresKey)) {
+                scoresLabel.format(scoresKey, "placar: fila %u (max %u)  escrita %.2f/%.2f ms  perdidos %llu",
+                    scoreStats.queueDepth, scoreStats.maxQueueDepth, scoreStats.writeAvgMs, scoreStats.writeMaxMs,
+                    static_cast<unsigned long long>(scoreStats.dropped));
+            }
+            DrawTextEx(gameFont, scoresLabel.c_str(), {20, 15.0f + (phaseCount + 4) * 20.0f}, 18, 1, {155, 89, 182, 255});
         }
-        
+
+        phase.next(ProfilePhase::Present);
         EndDrawing();
+        if (!firstFrameDrawn) {
+            firstFrameDrawn = true;
+            TraceLog(LOG_INFO, "Startup: primeiro quadro em %.1f ms", secondsSince(startupBegin) * 1000.0);
+        }
+        uint64_t cpu = Profiler::cpuNow();
+        uint64_t wall = Profiler::now();
+        (idle ? cpuIdleNs : cpuActiveNs) += cpu - lastCpu;
+        (idle ? wallIdleNs : wallActiveNs) += wall - lastWall;
+        lastCpu = cpu;
+        lastWall = wall;
+
+#ifdef DICE_ALLOC_HOOK
+        uint64_t frameAllocs = allocationCount() - allocsAtFrameStart;
+        // A bot's guess rebuilds messages just like a click does, and a
+        // merged record copies its name into the board.
+        inputThisFrame = inputThisFrame || app.guesses != guessesAtFrameStart || boardMerged;
+        if (++frameCount > allocWarmupFrames && !inputThisFrame) {
+            steadyFrames++;
+            if (frameAllocs > 0) {
+                allocatingFrames++;
+                TraceLog(LOG_WARNING, "AllocHook: quadro %d fez %llu alocacoes", frameCount,
+                    static_cast<unsigned long long>(frameAllocs));
+            }
+        }
+#endif
     }
 
-    UnloadMusicStream(bgm);
+    TraceLog(LOG_INFO, "Energia: ocioso %.2f s de cpu/min em %.0f s, ativo %.2f s de cpu/min em %.0f s, %llu redesenhos do painel",
+        cpuSecondsPerMinute(cpuIdleNs, wallIdleNs), wallIdleNs / 1e9,
+        cpuSecondsPerMinute(cpuActiveNs, wallActiveNs), wallActiveNs / 1e9,
+        static_cast<unsigned long long>(panelRedraws));
+
+#ifdef DICE_ALLOC_HOOK
+    TraceLog(LOG_INFO, "AllocHook: %d de %d quadros estaveis alocaram memoria", allocatingFrames, steadyFrames);
+#endif
+
+    recorder.close();
+    music.stop();
     CloseAudioDevice();
+    if (cachedRendering) {
+        UnloadRenderTexture(panelLayer);
+    }
     UnloadTexture(diceSheet);
+    glyphCache.unload();
+    releaseGameAssets(assets);
+    pack.close();
+    events.close();
+    EventLogStats eventStats = events.stats();
+    if (eventStats.events > 0 || eventStats.dropped > 0) {
+        TraceLog(LOG_INFO, "Eventos: %llu jogadas em %llu blocos (%llu bytes), %llu descartadas",
+            static_cast<unsigned long long>(eventStats.events), static_cast<unsigned long long>(eventStats.blocks),
+            static_cast<unsigned long long>(eventStats.bytes), static_cast<unsigned long long>(eventStats.dropped));
+    }
+    scores.close();
+    ScoreWriterStats scoreStats = scores.stats();
+    if (scoreStats.batches > 0 || scoreStats.dropped > 0) {
+        TraceLog(LOG_INFO, "Placar: %llu jogos em %llu lotes, escrita media %.2f ms (max %.2f ms), fila max %u, %llu reaberturas, %llu perdidos",
+            static_cast<unsigned long long>(scoreStats.games), static_cast<unsigned long long>(scoreStats.batches),
+            scoreStats.writeAvgMs, scoreStats.writeMaxMs, scoreStats.maxQueueDepth,
+            static_cast<unsigned long long>(scoreStats.reopens), static_cast<unsigned long long>(scoreStats.dropped));
+    }
     CloseWindow();
+#ifdef DICE_ALLOC_HOOK
+    if (allocatingFrames > 0) {
+        return 1;
+    }
+#endif
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "music_streamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+// dr_mp3 is compiled into raylib (raudio.c); only its declarations are
+// needed here.
+#include "dr_mp3.h"
+
+static const unsigned int decodeChunkFrames = 2048;
+static const size_t ringFrames = 16384;
+static const int maxChannels = 2;
+
+struct MusicStreamer::Decoder {
+    drmp3 mp3;
+};
+
+// raylib's stream callback carries no user pointer, so the playing
+// instance is kept here. Only one music stream plays at a time.
+static std::atomic<MusicStreamer*> activeStreamer{nullptr};
+
+MusicStreamer::MusicStreamer() : ring(ringFrames * maxChannels) {}
+
+MusicStreamer::~MusicStreamer() {
+    stop();
+}
+
+bool MusicStreamer::start(const unsigned char* data, int size) {
+    stop();
+    if (data == nullptr || size <= 0) {
+        return false;
+    }
+    decoder = new Decoder();
+    if (!drmp3_init_memory(&decoder->mp3, data, static_cast<size_t>(size), nullptr) ||
+        decoder->mp3.channels == 0 || decoder->mp3.channels > maxChannels) {
+        delete decoder;
+        decoder = nullptr;
+        return false;
+    }
+    channels = decoder->mp3.channels;
+    running.store(true);
+    worker = std::thread(&MusicStreamer::decodeLoop, this);
+
+    stream = LoadAudioStream(decoder->mp3.sampleRate, 16, channels);
+    activeStreamer.store(this);
+    SetAudioStreamCallback(stream, &MusicStreamer::feedDevice);
+    PlayAudioStream(stream);
+    return true;
+}
+
+void MusicStreamer::stop() {
+    if (decoder == nullptr) {
+        return;
+    }
+    StopAudioStream(stream);
+    UnloadAudioStream(stream);
+    activeStreamer.store(nullptr);
+    running.store(false);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    drmp3_uninit(&decoder->mp3);
+    delete decoder;
+    decoder = nullptr;
+}
+
+void MusicStreamer::feedDevice(void* buffer, unsigned int frames) {
+    MusicStreamer* self = activeStreamer.load(std::memory_order_acquire);
+    int16_t* out = static_cast<int16_t*>(buffer);
+    size_t wanted = static_cast<size_t>(frames) * (self != nullptr ? self->channels : maxChannels);
+    size_t got = self != nullptr ? self->ring.pop(out, wanted) : 0;
+    if (got < wanted) {
+        std::memset(out + got, 0, (wanted - got) * sizeof(int16_t));
+        if (self != nullptr) {
+            self->underruns.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void MusicStreamer::decodeLoop() {
+    int16_t chunk[decodeChunkFrames * maxChannels];
+    while (running.load(std::memory_order_relaxed)) {
+        if (ring.writable() < decodeChunkFrames * channels) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint64_t frames = drmp3_read_pcm_frames_s16(&decoder->mp3, decodeChunkFrames, chunk);
+        if (frames < decodeChunkFrames) {
+            drmp3_seek_to_pcm_frame(&decoder->mp3, 0);
+            uint64_t looped = drmp3_read_pcm_frames_s16(&decoder->mp3, decodeChunkFrames - frames, chunk + frames * channels);
+            if (frames == 0 && looped == 0) {
+                // Nothing decodes even from the first frame: a truncated or
+                // corrupt file would otherwise spin here forever.
+                TraceLog(LOG_WARNING, "Audio: musica sem quadros decodificaveis, parando");
+                return;
+            }
+            frames += looped;
+        }
+        uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        ring.push(chunk, static_cast<size_t>(frames) * channels);
+
+        buffersDecoded.fetch_add(1, std::memory_order_relaxed);
+        decodeNsTotal.fetch_add(ns, std::memory_order_relaxed);
+        if (ns > decodeNsMax.load(std::memory_order_relaxed)) {
+            decodeNsMax.store(ns, std::memory_order_relaxed);
+        }
+    }
+}
+
+MusicStats MusicStreamer::stats() const {
+    MusicStats result = {};
+    result.underruns = underruns.load(std::memory_order_relaxed);
+    result.buffersDecoded = buffersDecoded.load(std::memory_order_relaxed);
+    if (result.buffersDecoded > 0) {
+        result.decodeAvgUs = decodeNsTotal.load(std::memory_order_relaxed) / 1e3 / result.buffersDecoded;
+    }
+    result.decodeMaxUs = decodeNsMax.load(std::memory_order_relaxed) / 1e3;
+    result.bufferedFrames = channels > 0 ? ring.readable() / channels : 0;
+    return result;
+}
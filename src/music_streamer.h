@@ -0,0 +1,47 @@
+#pragma once
+
+#include <raylib.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "spsc_ring.h"
+
+struct MusicStats {
+    uint64_t underruns;
+    uint64_t buffersDecoded;
+    double decodeAvgUs;
+    double decodeMaxUs;
+    size_t bufferedFrames;
+};
+
+// Plays looping background music without touching the render loop. A
+// decoder thread turns the MP3 into 16-bit PCM and feeds a lock-free ring;
+// the audio device callback drains the ring and counts an underrun
+// whenever it has to pad with silence.
+class MusicStreamer {
+public:
+    MusicStreamer();
+    ~MusicStreamer();
+    MusicStreamer(const MusicStreamer&) = delete;
+    MusicStreamer& operator=(const MusicStreamer&) = delete;
+
+    bool start(const unsigned char* data, int size);
+    void stop();
+    MusicStats stats() const;
+
+private:
+    static void feedDevice(void* buffer, unsigned int frames);
+    void decodeLoop();
+
+    struct Decoder;
+    Decoder* decoder = nullptr;
+    AudioStream stream = {};
+    unsigned int channels = 0;
+    SpscRing<int16_t> ring;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> underruns{0};
+    std::atomic<uint64_t> buffersDecoded{0};
+    std::atomic<uint64_t> decodeNsTotal{0};
+    std::atomic<uint64_t> decodeNsMax{0};
+};
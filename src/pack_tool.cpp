@@ -0,0 +1,57 @@
+#include <raylib.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "asset_pack.h"
+#include "assets.h"
+
+int main(int argc, char** argv) {
+    std::string resources = argc > 1 ? argv[1] : "resources";
+    std::string output = argc > 2 ? argv[2] : resources + "/assets.pak";
+    AssetPackWriter writer;
+
+    std::string dicePath = resources + "/clipart1023082.png";
+    Image dice = LoadImage(dicePath.c_str());
+    if (dice.data == nullptr) {
+        std::fprintf(stderr, "Nao foi possivel ler %s\n", dicePath.c_str());
+        return 1;
+    }
+    ImageFormat(&dice, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    writer.add("dice", AssetType::Image, dice.width, dice.height, dice.format, dice.data,
+        GetPixelDataSize(dice.width, dice.height, dice.format));
+    UnloadImage(dice);
+
+    std::string musicPath = resources + "/music.mp3";
+    unsigned int musicSize = 0;
+    unsigned char* music = LoadFileData(musicPath.c_str(), &musicSize);
+    if (music != nullptr) {
+        writer.add("music.mp3", AssetType::Blob, 0, 0, 0, music, musicSize);
+        UnloadFileData(music);
+    }
+
+    std::string fontPath = resources + "/font.ttf";
+    Image atlas = {};
+    std::vector<PackGlyph> glyphs;
+    const int fontSize = 32;
+    if (bakeFontAtlas(fontPath.c_str(), fontSize, atlas, glyphs)) {
+        writer.add("font.atlas", AssetType::Image, atlas.width, atlas.height, atlas.format, atlas.data,
+            GetPixelDataSize(atlas.width, atlas.height, atlas.format));
+        writer.add("font.glyphs", AssetType::Glyphs, fontSize, static_cast<uint32_t>(glyphs.size()), 0,
+            glyphs.data(), glyphs.size() * sizeof(PackGlyph));
+        UnloadImage(atlas);
+        // Kept for glyphs outside the baked set, rasterized on first use.
+        unsigned int ttfSize = 0;
+        unsigned char* ttf = LoadFileData(fontPath.c_str(), &ttfSize);
+        if (ttf != nullptr) {
+            writer.add("font.ttf", AssetType::Blob, 0, 0, 0, ttf, ttfSize);
+            UnloadFileData(ttf);
+        }
+    }
+
+    if (!writer.write(output)) {
+        std::fprintf(stderr, "Nao foi possivel escrever %s\n", output.c_str());
+        return 1;
+    }
+    std::printf("%s gravado\n", output.c_str());
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+static const size_t phaseCount = static_cast<size_t>(ProfilePhase::Count);
+
+const char* profilePhaseName(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::Frame: return "Frame";
+        case ProfilePhase::Logic: return "Logic";
+        case ProfilePhase::Text: return "Text";
+        case ProfilePhase::Scoreboard: return "Scoreboard";
+        case ProfilePhase::Dice: return "Dice";
+        case ProfilePhase::Panels: return "Panels";
+        case ProfilePhase::Present: return "Present";
+        case ProfilePhase::Count: break;
+    }
+    return "?";
+}
+
+uint64_t Profiler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t Profiler::cpuNow() {
+    timespec ts = {};
+    ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void Profiler::record(ProfilePhase phase, uint64_t startNs, uint64_t endNs) {
+    uint64_t duration = endNs - startNs;
+    uint64_t index = written.load(std::memory_order_relaxed);
+    events[index & (eventCapacity - 1)] = {
+        startNs,
+        static_cast<uint32_t>(std::min<uint64_t>(duration, UINT32_MAX)),
+        frameIndex,
+        phase
+    };
+    written.store(index + 1, std::memory_order_release);
+
+    size_t row = frameIndex % frameHistory;
+    phaseTotals[row][static_cast<size_t>(phase)] += duration / 1e6;
+    if (phase == ProfilePhase::Frame) {
+        frameMs[row] = duration / 1e6;
+        frameIndex++;
+        framesSeen = std::min(framesSeen + 1, frameHistory);
+        std::fill(phaseTotals[frameIndex % frameHistory], phaseTotals[frameIndex % frameHistory] + phaseCount, 0.0);
+    }
+}
+
+ProfileSummary Profiler::summarize(size_t frames) {
+    ProfileSummary summary = {};
+    if (framesSeen == 0) {
+        return summary;
+    }
+    frames = std::max<size_t>(1, std::min(frames, framesSeen));
+    for (size_t i = 1; i <= frames; i++) {
+        size_t row = (frameIndex + frameHistory - i) % frameHistory;
+        for (size_t p = 0; p < phaseCount; p++) {
+            summary.phaseMs[p] += phaseTotals[row][p];
+        }
+    }
+    for (size_t p = 0; p < phaseCount; p++) {
+        summary.phaseMs[p] /= static_cast<double>(frames);
+    }
+
+    for (size_t i = 0; i < framesSeen; i++) {
+        sortScratch[i] = frameMs[(frameIndex + frameHistory - 1 - i) % frameHistory];
+    }
+    double* end = sortScratch + framesSeen;
+    size_t p50 = (framesSeen - 1) / 2;
+    size_t p99 = (framesSeen - 1) * 99 / 100;
+    std::nth_element(sortScratch, sortScratch + p50, end);
+    summary.frameP50Ms = sortScratch[p50];
+    std::nth_element(sortScratch, sortScratch + p99, end);
+    summary.frameP99Ms = sortScratch[p99];
+    summary.frameMaxMs = *std::max_element(sortScratch, end);
+    return summary;
+}
+
+bool Profiler::writeChromeTrace(const char* path) const {
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    uint64_t end = written.load(std::memory_order_acquire);
+    uint64_t begin = end > eventCapacity ? end - eventCapacity : 0;
+    // Frame is recorded after the phases inside it, so the oldest event in
+    // record order is not the earliest one.
+    uint64_t origin = UINT64_MAX;
+    for (uint64_t i = begin; i < end; i++) {
+        origin = std::min(origin, events[i & (eventCapacity - 1)].startNs);
+    }
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    for (uint64_t i = begin; i < end; i++) {
+        const ProfileEvent& event = events[i & (eventCapacity - 1)];
+        std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+            "\"pid\":1,\"tid\":1,\"args\":{\"frame\":%u}}",
+            i == begin ? "" : ",\n", profilePhaseName(event.phase),
+            (event.startNs - origin) / 1e3, event.durationNs / 1e3, event.frame);
+    }
+    std::fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class ProfilePhase : uint8_t {
+    Frame,
+    Logic,
+    Text,
+    Scoreboard,
+    Dice,
+    // Re-rendering the cached panel layer, only on frames that change it.
+    Panels,
+    Present,
+    Count
+};
+
+const char* profilePhaseName(ProfilePhase phase);
+
+struct ProfileEvent {
+    uint64_t startNs;
+    uint32_t durationNs;
+    uint32_t frame;
+    ProfilePhase phase;
+};
+
+struct ProfileSummary {
+    double phaseMs[static_cast<size_t>(ProfilePhase::Count)];
+    double frameP50Ms;
+    double frameP99Ms;
+    double frameMaxMs;
+};
+
+// Records timed phases of the main loop into a fixed ring of events. Only
+// the render thread records or reads: once the ring wraps, old slots are
+// overwritten in place, so a reader on another thread could see torn
+// events. Nothing here allocates after construction.
+class Profiler {
+public:
+    static constexpr size_t eventCapacity = 1 << 15;
+    static constexpr size_t frameHistory = 600;
+
+    static uint64_t now();
+    // CPU time of the whole process, all threads, in nanoseconds.
+    static uint64_t cpuNow();
+
+    // Recording a Frame event closes the current frame.
+    void record(ProfilePhase phase, uint64_t startNs, uint64_t endNs);
+    uint32_t frame() const { return frameIndex; }
+
+    // Averages over the last `frames` frames plus percentiles of the frame
+    // time history.
+    ProfileSummary summarize(size_t frames);
+    bool writeChromeTrace(const char* path) const;
+
+private:
+    ProfileEvent events[eventCapacity];
+    std::atomic<uint64_t> written{0};
+    uint32_t frameIndex = 0;
+
+    double phaseTotals[frameHistory][static_cast<size_t>(ProfilePhase::Count)] = {};
+    double frameMs[frameHistory] = {};
+    double sortScratch[frameHistory] = {};
+    size_t framesSeen = 0;
+};
+
+// Times one phase at a time for the lifetime of the scope; next() closes
+// the running phase and opens another.
+class ProfileScope {
+public:
+    ProfileScope(Profiler& profiler, ProfilePhase phase) : profiler(profiler), phase(phase), start(Profiler::now()) {}
+    ~ProfileScope() { profiler.record(phase, start, Profiler::now()); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    void next(ProfilePhase nextPhase) {
+        uint64_t t = Profiler::now();
+        profiler.record(phase, start, t);
+        phase = nextPhase;
+        start = t;
+    }
+
+private:
+    Profiler& profiler;
+    ProfilePhase phase;
+    uint64_t start;
+};
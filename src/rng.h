@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** seeded through splitmix64. One instance is seeded once per
+// process (or per worker thread via jump()) and every target is drawn from
+// it, so a run is reproducible from its seed alone.
+class Rng {
+public:
+    using result_type = uint64_t;
+
+    explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        for (auto& word : state) {
+            seed += 0x9e3779b97f4a7c15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Unbiased integer in [lo, hi] (Lemire's multiply-and-reject).
+    int uniform(int lo, int hi) {
+        uint32_t range = static_cast<uint32_t>(hi - lo) + 1;
+        uint64_t product = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * range;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < range) {
+            uint32_t threshold = -range % range;
+            while (low < threshold) {
+                product = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * range;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return lo + static_cast<int>(product >> 32);
+    }
+
+    void fillTargets(int* out, size_t count, int maxNumber) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = uniform(1, maxNumber);
+        }
+    }
+
+    // Advances the state by 2^128 draws; gives non-overlapping streams for
+    // worker threads sharing one seed.
+    void jump() {
+        static const uint64_t jumpTable[] = {
+            0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull
+        };
+        uint64_t next[4] = {0, 0, 0, 0};
+        for (uint64_t word : jumpTable) {
+            for (int bit = 0; bit < 64; bit++) {
+                if (word & (1ull << bit)) {
+                    for (int i = 0; i < 4; i++) {
+                        next[i] ^= state[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            state[i] = next[i];
+        }
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t state[4];
+};
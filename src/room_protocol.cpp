@@ -0,0 +1,126 @@
+#include "room_protocol.h"
+
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const size_t readChunk = 16384;
+
+void appendMessage(WireBuffer& wire, MsgType type, const void* payload, size_t size,
+                   const void* extra, size_t extraSize) {
+    MsgHeader header = {static_cast<uint16_t>(size + extraSize), type};
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+    wire.out.insert(wire.out.end(), bytes, bytes + sizeof(header));
+    bytes = static_cast<const uint8_t*>(payload);
+    wire.out.insert(wire.out.end(), bytes, bytes + size);
+    if (extraSize > 0) {
+        bytes = static_cast<const uint8_t*>(extra);
+        wire.out.insert(wire.out.end(), bytes, bytes + extraSize);
+    }
+}
+
+bool readAvailable(int fd, WireBuffer& wire) {
+    uint8_t chunk[readChunk];
+    for (;;) {
+        ssize_t got = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (got > 0) {
+            wire.in.insert(wire.in.end(), chunk, chunk + got);
+            if (static_cast<size_t>(got) < sizeof(chunk)) {
+                return true;
+            }
+            continue;
+        }
+        if (got == 0) {
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+bool flushOut(int fd, WireBuffer& wire) {
+    while (wire.outSent < wire.out.size()) {
+        ssize_t sent = ::send(fd, wire.out.data() + wire.outSent, wire.out.size() - wire.outSent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            wire.outSent += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+        return false;
+    }
+    wire.out.clear();
+    wire.outSent = 0;
+    return true;
+}
+
+bool hasPendingOut(const WireBuffer& wire) {
+    return wire.outSent < wire.out.size();
+}
+
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static void setNoDelay(int fd) {
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+int listenTcp(uint16_t port, int backlog) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, backlog) != 0 || !setNonBlocking(fd)) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int connectTcp(const char* host, uint16_t port) {
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        return -1;
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || !setNonBlocking(fd)) {
+        ::close(fd);
+        return -1;
+    }
+    setNoDelay(fd);
+    return fd;
+}
+
+int acceptTcp(int listenFd) {
+    int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+    if (fd >= 0) {
+        setNoDelay(fd);
+    }
+    return fd;
+}
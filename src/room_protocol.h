@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Wire format shared by dice_server and dice_loadgen. Every message is a
+// 3-byte header (payload size, type) followed by a fixed-size payload;
+// Join alone carries a trailing name. Integers are host order: both ends
+// run on the same little-endian boxes.
+enum class MsgType : uint8_t {
+    Join = 1,
+    Guess = 2,
+    StatsRequest = 3,
+    Joined = 16,
+    Turn = 17,
+    GameOver = 18,
+    Error = 19,
+    Stats = 20
+};
+
+enum class RoomError : uint8_t {
+    BadMessage = 1,
+    RoomFull = 2,
+    NotYourTurn = 3,
+    RoomClosed = 4
+};
+
+// Sent in Join; the server turns away clients built for another version.
+// Version 2 widened the try counts to 32 bits.
+const uint8_t protocolVersion = 2;
+
+// Turn::result for a turn that starts without a guess behind it.
+const uint8_t turnStarted = 0xFF;
+// GameOver::winner when the best score is shared.
+const uint8_t winnerTie = 0xFF;
+
+#pragma pack(push, 1)
+struct MsgHeader {
+    uint16_t size;
+    MsgType type;
+};
+
+struct JoinMsg {
+    uint8_t version;
+    uint32_t room;
+    uint8_t players;
+    uint8_t nameLength;
+};
+
+struct GuessMsg {
+    int32_t value;
+};
+
+struct JoinedMsg {
+    uint32_t room;
+    uint8_t seat;
+    uint8_t players;
+};
+
+// Broadcast to the whole room after every guess and at each new game.
+// `result` is a GuessResult, or turnStarted.
+struct TurnMsg {
+    uint8_t seat;
+    uint8_t result;
+    uint32_t tries;
+    int32_t lowerBound;
+    int32_t upperBound;
+};
+
+struct GameOverMsg {
+    uint8_t winner;
+    uint8_t winners;
+    uint32_t minTries;
+    int32_t bestScore;
+};
+
+struct ErrorMsg {
+    RoomError code;
+};
+
+struct StatsMsg {
+    uint32_t rooms;
+    uint32_t connections;
+    uint64_t turns;
+    uint64_t games;
+    uint64_t cpuMicros;
+};
+#pragma pack(pop)
+
+// Buffered non-blocking socket. `in` keeps a partial trailing message
+// between reads; `out` whatever the kernel did not take yet.
+struct WireBuffer {
+    std::vector<uint8_t> in;
+    std::vector<uint8_t> out;
+    size_t outSent = 0;
+};
+
+void appendMessage(WireBuffer& wire, MsgType type, const void* payload, size_t size,
+                   const void* extra = nullptr, size_t extraSize = 0);
+
+template <typename T>
+void appendMessage(WireBuffer& wire, MsgType type, const T& payload) {
+    appendMessage(wire, type, &payload, sizeof(payload));
+}
+
+// Reads everything the socket has. False once the peer closed or failed.
+bool readAvailable(int fd, WireBuffer& wire);
+// Writes as much of `out` as the socket accepts. False on a hard error.
+bool flushOut(int fd, WireBuffer& wire);
+bool hasPendingOut(const WireBuffer& wire);
+
+// Calls handler(type, payload, size) for each complete message in `in`
+// and drops the consumed bytes. Stops early when the handler returns false.
+template <typename Handler>
+void drainMessages(WireBuffer& wire, Handler handler) {
+    size_t offset = 0;
+    while (wire.in.size() - offset >= sizeof(MsgHeader)) {
+        MsgHeader header;
+        std::memcpy(&header, wire.in.data() + offset, sizeof(header));
+        if (wire.in.size() - offset < sizeof(header) + header.size) {
+            break;
+        }
+        const uint8_t* payload = wire.in.data() + offset + sizeof(header);
+        offset += sizeof(header) + header.size;
+        if (!handler(header.type, payload, static_cast<size_t>(header.size))) {
+            break;
+        }
+    }
+    wire.in.erase(wire.in.begin(), wire.in.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+// Non-blocking TCP helpers; -1 on failure.
+int listenTcp(uint16_t port, int backlog);
+int connectTcp(const char* host, uint16_t port);
+int acceptTcp(int listenFd);
+bool setNonBlocking(int fd);
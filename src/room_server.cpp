@@ -0,0 +1,486 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "game.h"
+#include "rng.h"
+#include "room_protocol.h"
+#include "leaderboard.h"
+#include "score_writer.h"
+
+struct ServerOptions {
+    uint16_t port = 7777;
+    int players = 2;
+    int maxNumber = 6;
+    const char* scoreboard = "scoreboard.bin";
+    ScoreWriterOptions scoreOptions;
+    uint64_t seed = 0;
+    bool seeded = false;
+};
+
+struct Connection {
+    bool open = false;
+    bool joined = false;
+    bool wantsWrite = false;
+    uint32_t room = 0;
+    int seat = -1;
+    WireBuffer wire;
+};
+
+// One table: the same GameSession the window game runs, with one socket
+// per seat. A new game starts as soon as the last seat is taken and again
+// after every game over.
+struct Room {
+    GameSession session;
+    std::vector<int> seats;
+    size_t capacity = 0;
+};
+
+static volatile std::sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+class RoomServer {
+public:
+    RoomServer(const ServerOptions& options, Leaderboard& leaderboard, ScoreWriter& scores, Rng& rng)
+        : options(options), leaderboard(leaderboard), scores(scores), rng(rng) {}
+
+    bool start();
+    void run();
+    void shutdown();
+
+private:
+    void acceptAll();
+    void onReadable(int fd);
+    void closeConnection(int fd);
+    bool handleMessage(int fd, MsgType type, const uint8_t* payload, size_t size);
+    bool join(int fd, const JoinMsg& msg, const char* name);
+    bool guess(int fd, const GuessMsg& msg);
+    void startGame(Room& room);
+    void broadcastTurn(Room& room, GuessResult result, bool started);
+    void sendError(int fd, RoomError code);
+    void markDirty(int fd);
+    void flushDirty();
+    void flushBatch();
+    void reportStats();
+    uint64_t cpuMicros() const;
+
+    const ServerOptions& options;
+    Leaderboard& leaderboard;
+    ScoreWriter& scores;
+    Rng& rng;
+    int epollFd = -1;
+    int listenFd = -1;
+    std::vector<Connection> connections;
+    std::vector<int> dirty;
+    std::vector<int> flushing;
+    std::unordered_map<uint32_t, Room> rooms;
+    size_t openConnections = 0;
+    uint64_t turns = 0;
+    uint64_t games = 0;
+    uint64_t reportedTurns = 0;
+    uint64_t reportedCpu = 0;
+    std::chrono::steady_clock::time_point reportedAt;
+};
+
+uint64_t RoomServer::cpuMicros() const {
+    rusage usage = {};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ull +
+        static_cast<uint64_t>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+bool RoomServer::start() {
+    listenFd = listenTcp(options.port, 4096);
+    if (listenFd < 0) {
+        return false;
+    }
+    epollFd = ::epoll_create1(0);
+    if (epollFd < 0) {
+        return false;
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    reportedAt = std::chrono::steady_clock::now();
+    reportedCpu = cpuMicros();
+    return true;
+}
+
+void RoomServer::run() {
+    const int maxEvents = 1024;
+    epoll_event events[maxEvents];
+    while (!stopRequested) {
+        int count = ::epoll_wait(epollFd, events, maxEvents, 1000);
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptAll();
+                continue;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(fd);
+                continue;
+            }
+            if (events[i].events & EPOLLIN) {
+                onReadable(fd);
+            }
+            if ((events[i].events & EPOLLOUT) && connections[fd].open) {
+                markDirty(fd);
+            }
+        }
+        flushDirty();
+        scores.applyMerged(leaderboard);
+        if (std::chrono::steady_clock::now() - reportedAt >= std::chrono::seconds(5)) {
+            reportStats();
+        }
+    }
+}
+
+void RoomServer::shutdown() {
+    for (size_t fd = 0; fd < connections.size(); fd++) {
+        if (connections[fd].open) {
+            ::close(static_cast<int>(fd));
+        }
+    }
+    if (listenFd >= 0) {
+        ::close(listenFd);
+    }
+    if (epollFd >= 0) {
+        ::close(epollFd);
+    }
+}
+
+void RoomServer::acceptAll() {
+    for (;;) {
+        int fd = acceptTcp(listenFd);
+        if (fd < 0) {
+            return;
+        }
+        if (static_cast<size_t>(fd) >= connections.size()) {
+            connections.resize(static_cast<size_t>(fd) + 1);
+        }
+        connections[fd] = Connection{};
+        connections[fd].open = true;
+        openConnections++;
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+void RoomServer::onReadable(int fd) {
+    Connection& conn = connections[fd];
+    bool alive = readAvailable(fd, conn.wire);
+    bool valid = true;
+    drainMessages(conn.wire, [&](MsgType type, const uint8_t* payload, size_t size) {
+        valid = handleMessage(fd, type, payload, size);
+        return valid;
+    });
+    if (!alive || !valid) {
+        closeConnection(fd);
+    }
+}
+
+void RoomServer::closeConnection(int fd) {
+    Connection& conn = connections[fd];
+    if (!conn.open) {
+        return;
+    }
+    if (conn.joined) {
+        // A table cannot go on with an empty seat: everyone else is told
+        // and may join again.
+        auto found = rooms.find(conn.room);
+        if (found != rooms.end()) {
+            for (int other : found->second.seats) {
+                if (other != fd) {
+                    connections[other].joined = false;
+                    sendError(other, RoomError::RoomClosed);
+                }
+            }
+            rooms.erase(found);
+        }
+    }
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    conn = Connection{};
+    openConnections--;
+}
+
+bool RoomServer::handleMessage(int fd, MsgType type, const uint8_t* payload, size_t size) {
+    switch (type) {
+        case MsgType::Join: {
+            JoinMsg msg;
+            if (size < sizeof(msg)) {
+                return false;
+            }
+            std::memcpy(&msg, payload, sizeof(msg));
+            if (size != sizeof(msg) + msg.nameLength) {
+                return false;
+            }
+            return join(fd, msg, reinterpret_cast<const char*>(payload + sizeof(msg)));
+        }
+        case MsgType::Guess: {
+            GuessMsg msg;
+            if (size != sizeof(msg)) {
+                return false;
+            }
+            std::memcpy(&msg, payload, sizeof(msg));
+            return guess(fd, msg);
+        }
+        case MsgType::StatsRequest: {
+            StatsMsg stats = {static_cast<uint32_t>(rooms.size()), static_cast<uint32_t>(openConnections),
+                turns, games, cpuMicros()};
+            appendMessage(connections[fd].wire, MsgType::Stats, stats);
+            markDirty(fd);
+            return true;
+        }
+        default:
+            sendError(fd, RoomError::BadMessage);
+            return false;
+    }
+}
+
+bool RoomServer::join(int fd, const JoinMsg& msg, const char* name) {
+    Connection& conn = connections[fd];
+    if (conn.joined || msg.version != protocolVersion) {
+        sendError(fd, RoomError::BadMessage);
+        return true;
+    }
+    Room& room = rooms[msg.room];
+    if (room.capacity == 0) {
+        room.capacity = static_cast<size_t>(msg.players > 0 ? msg.players : options.players);
+        room.session.maxNumber = options.maxNumber;
+    }
+    if (room.seats.size() >= room.capacity) {
+        sendError(fd, RoomError::RoomFull);
+        return true;
+    }
+    conn.joined = true;
+    conn.room = msg.room;
+    conn.seat = static_cast<int>(room.seats.size());
+    room.seats.push_back(fd);
+    std::string playerName(name, std::min<size_t>(msg.nameLength, ScoreStore::maxNameLength));
+    if (playerName.empty()) {
+        playerName = "Jogador " + std::to_string(conn.seat + 1);
+    }
+    int id = leaderboard.findId(playerName);
+    int best = id >= 0 ? leaderboard.entry(id).bestScore : 0;
+    room.session.players.push_back({playerName, 0, best});
+
+    JoinedMsg joined = {msg.room, static_cast<uint8_t>(conn.seat), static_cast<uint8_t>(room.capacity)};
+    appendMessage(conn.wire, MsgType::Joined, joined);
+    markDirty(fd);
+    if (room.seats.size() == room.capacity) {
+        startGame(room);
+    }
+    return true;
+}
+
+bool RoomServer::guess(int fd, const GuessMsg& msg) {
+    Connection& conn = connections[fd];
+    if (!conn.joined) {
+        sendError(fd, RoomError::BadMessage);
+        return true;
+    }
+    Room& room = rooms[conn.room];
+    GameSession& session = room.session;
+    if (room.seats.size() < room.capacity || session.finished || session.currentPlayer != conn.seat) {
+        sendError(fd, RoomError::NotYourTurn);
+        return true;
+    }
+    if (!session.inWindow(msg.value)) {
+        sendError(fd, RoomError::BadMessage);
+        return true;
+    }
+    GuessResult result = session.guess(msg.value);
+    turns++;
+    if (result == GuessResult::GameOver) {
+        games++;
+        GameOutcome outcome = session.outcome();
+        GameOverMsg over = {};
+        over.winner = outcome.winners > 1 ? winnerTie : static_cast<uint8_t>(outcome.winner);
+        over.winners = static_cast<uint8_t>(outcome.winners);
+        over.minTries = static_cast<uint32_t>(outcome.minTries);
+        for (size_t seat = 0; seat < room.seats.size(); seat++) {
+            Player& player = session.players[seat];
+            player.bestScore = leaderboard.recordGame(player.name, player.tries);
+            scores.recordGame(player.name, player.tries);
+            over.bestScore = player.bestScore;
+            appendMessage(connections[room.seats[seat]].wire, MsgType::GameOver, over);
+            markDirty(room.seats[seat]);
+        }
+        startGame(room);
+        return true;
+    }
+    if (result == GuessResult::Correct) {
+        session.beginTurn(rng.uniform(1, session.maxNumber));
+    }
+    broadcastTurn(room, result, false);
+    return true;
+}
+
+void RoomServer::startGame(Room& room) {
+    room.session.reset();
+    room.session.beginTurn(rng.uniform(1, room.session.maxNumber));
+    broadcastTurn(room, GuessResult::Correct, true);
+}
+
+void RoomServer::broadcastTurn(Room& room, GuessResult result, bool started) {
+    const GameSession& session = room.session;
+    TurnMsg turn = {};
+    turn.seat = static_cast<uint8_t>(session.currentPlayer);
+    turn.result = started ? turnStarted : static_cast<uint8_t>(result);
+    turn.tries = static_cast<uint32_t>(session.players[session.currentPlayer].tries);
+    turn.lowerBound = session.lowerBound;
+    turn.upperBound = session.upperBound;
+    for (int fd : room.seats) {
+        appendMessage(connections[fd].wire, MsgType::Turn, turn);
+        markDirty(fd);
+    }
+}
+
+void RoomServer::sendError(int fd, RoomError code) {
+    ErrorMsg error = {code};
+    appendMessage(connections[fd].wire, MsgType::Error, error);
+    markDirty(fd);
+}
+
+void RoomServer::markDirty(int fd) {
+    dirty.push_back(fd);
+}
+
+// Replies are batched: everything queued while handling one epoll round
+// goes out in a single send() per socket.
+void RoomServer::flushDirty() {
+    // Closing a socket below can queue RoomClosed for its table, so keep
+    // going until nothing new was queued.
+    while (!dirty.empty()) {
+        flushing.swap(dirty);
+        flushBatch();
+    }
+}
+
+void RoomServer::flushBatch() {
+    std::sort(flushing.begin(), flushing.end());
+    flushing.erase(std::unique(flushing.begin(), flushing.end()), flushing.end());
+    for (int fd : flushing) {
+        Connection& conn = connections[fd];
+        if (!conn.open) {
+            continue;
+        }
+        if (!flushOut(fd, conn.wire)) {
+            closeConnection(fd);
+            continue;
+        }
+        bool pending = hasPendingOut(conn.wire);
+        if (pending != conn.wantsWrite) {
+            conn.wantsWrite = pending;
+            epoll_event event = {};
+            event.events = pending ? EPOLLIN | EPOLLOUT : EPOLLIN;
+            event.data.fd = fd;
+            ::epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+        }
+    }
+    flushing.clear();
+}
+
+void RoomServer::reportStats() {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t cpu = cpuMicros();
+    double seconds = std::chrono::duration<double>(now - reportedAt).count();
+    double cores = (cpu - reportedCpu) / 1e6 / seconds;
+    ScoreWriterStats scoreStats = scores.stats();
+    std::printf("salas: %zu  conexoes: %zu  turnos/s: %.0f  cpu: %.1f%%  salas por nucleo: %.0f  "
+        "placar: fila %u (max %u) escrita %.2f/%.2f ms perdidos %llu\n",
+        rooms.size(), openConnections, (turns - reportedTurns) / seconds, cores * 100.0,
+        cores > 0.0 ? rooms.size() / cores : 0.0, scoreStats.queueDepth, scoreStats.maxQueueDepth,
+        scoreStats.writeAvgMs, scoreStats.writeMaxMs, static_cast<unsigned long long>(scoreStats.dropped));
+    std::fflush(stdout);
+    reportedAt = now;
+    reportedCpu = cpu;
+    reportedTurns = turns;
+}
+
+static void printUsage(const char* program) {
+    std::fprintf(stderr, "Uso: %s [--port N] [--players N] [--max N] [--scoreboard ARQUIVO] [--fsync never|batch|interval] [--seed N]\n", program);
+}
+
+int main(int argc, char** argv) {
+    ServerOptions options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (std::strcmp(arg, "--port") == 0) {
+            options.port = static_cast<uint16_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--players") == 0) {
+            options.players = std::atoi(value);
+        } else if (std::strcmp(arg, "--max") == 0) {
+            options.maxNumber = std::atoi(value);
+        } else if (std::strcmp(arg, "--scoreboard") == 0) {
+            options.scoreboard = value;
+        } else if (std::strcmp(arg, "--fsync") == 0) {
+            if (!parseFsyncPolicy(value, options.scoreOptions.fsync)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+            options.seeded = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (options.players <= 0 || options.players > 255 || options.maxNumber <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!options.seeded) {
+        std::random_device rd;
+        options.seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    // Game overs come in bursts from every room at once; the ring only has
+    // to hold them until the next batch.
+    Leaderboard leaderboard;
+    ScoreWriter scores(1 << 16);
+    if (!scores.open(options.scoreboard, options.scoreOptions, leaderboard)) {
+        std::fprintf(stderr, "Nao foi possivel abrir %s\n", options.scoreboard);
+        return 1;
+    }
+    Rng rng(options.seed);
+    RoomServer server(options, leaderboard, scores, rng);
+    if (!server.start()) {
+        std::fprintf(stderr, "Nao foi possivel escutar na porta %u\n", options.port);
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::printf("dice_server: porta %u  jogadores por sala: %d  semente: %llu\n", options.port, options.players,
+        static_cast<unsigned long long>(options.seed));
+    std::fflush(stdout);
+
+    server.run();
+    server.shutdown();
+    scores.close();
+    return 0;
+}
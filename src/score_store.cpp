@@ -0,0 +1,425 @@
+#include "score_store.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct ScoreStore::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t recordCapacity;
+    uint32_t recordCount;
+    // Record updates ever made; update n is journal slot n % journalLength.
+    uint64_t changeCount;
+};
+
+static const char storeMagic[8] = {'D', 'I', 'C', 'E', 'S', 'C', 'B', '1'};
+// Version 2 appends the change journal; a version 1 file is extended in
+// place on open.
+static const uint32_t storeVersion = 2;
+static const uint32_t journalVersion = 2;
+static const uint32_t initialCapacity = 1024;
+
+static size_t storeLength(uint32_t slotCount, uint32_t recordCapacity, uint32_t version = storeVersion) {
+    size_t length = sizeof(ScoreStore::Header) + slotCount * sizeof(uint32_t) + recordCapacity * sizeof(ScoreRecord);
+    return version >= journalVersion ? length + ScoreStore::journalLength * sizeof(uint32_t) : length;
+}
+
+static size_t clampedLength(const std::string& name) {
+    return name.size() < ScoreStore::maxNameLength ? name.size() : ScoreStore::maxNameLength;
+}
+
+ScoreStore::~ScoreStore() {
+    close();
+}
+
+uint64_t ScoreStore::hashName(const char* name, size_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+ScoreStore::Header* ScoreStore::header() const {
+    return reinterpret_cast<Header*>(base);
+}
+
+uint32_t* ScoreStore::slots() const {
+    return reinterpret_cast<uint32_t*>(base + sizeof(Header));
+}
+
+ScoreRecord* ScoreStore::records() const {
+    return reinterpret_cast<ScoreRecord*>(base + sizeof(Header) + header()->slotCount * sizeof(uint32_t));
+}
+
+uint32_t* ScoreStore::journal() const {
+    return reinterpret_cast<uint32_t*>(records() + header()->recordCapacity);
+}
+
+bool ScoreStore::create(const std::string& target, uint32_t recordCapacity) {
+    int out = ::open(target.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        return false;
+    }
+    Header fresh = {};
+    std::memcpy(fresh.magic, storeMagic, sizeof(storeMagic));
+    fresh.version = storeVersion;
+    fresh.slotCount = recordCapacity * 2;
+    fresh.recordCapacity = recordCapacity;
+    bool ok = ::ftruncate(out, static_cast<off_t>(storeLength(fresh.slotCount, recordCapacity))) == 0 &&
+        ::pwrite(out, &fresh, sizeof(fresh), 0) == static_cast<ssize_t>(sizeof(fresh));
+    ::close(out);
+    return ok;
+}
+
+bool ScoreStore::map(size_t length) {
+    void* mapped = ::mmap(nullptr, length, readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    base = static_cast<unsigned char*>(mapped);
+    mappedLength = length;
+    return true;
+}
+
+bool ScoreStore::open(const std::string& storePath) {
+    close();
+    path = storePath;
+    readOnly = false;
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0 || info.st_size == 0) {
+        if (!create(path, initialCapacity)) {
+            return false;
+        }
+    }
+    fd = ::open(path.c_str(), O_RDWR);
+    return attach();
+}
+
+bool ScoreStore::openReadOnly(const std::string& storePath) {
+    close();
+    path = storePath;
+    readOnly = true;
+    fd = ::open(path.c_str(), O_RDONLY);
+    return attach();
+}
+
+// Maps the file open on `fd` once it checks out.
+bool ScoreStore::attach() {
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        close();
+        return false;
+    }
+    if (!map(static_cast<size_t>(info.st_size))) {
+        close();
+        return false;
+    }
+    if (!valid()) {
+        close();
+        return false;
+    }
+    if (!readOnly && header()->version < journalVersion && !addJournal()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Rejects a damaged file before anything indexes into it: probing needs a
+// power-of-two index with at least one free slot, and every slot has to
+// point at an existing record.
+bool ScoreStore::valid() const {
+    const Header* h = header();
+    if (std::memcmp(h->magic, storeMagic, sizeof(storeMagic)) != 0 || h->version == 0 || h->version > storeVersion ||
+        storeLength(h->slotCount, h->recordCapacity, h->version) != mappedLength || h->recordCount > h->recordCapacity) {
+        return false;
+    }
+    if (h->slotCount == 0 || (h->slotCount & (h->slotCount - 1)) != 0 || h->slotCount <= h->recordCapacity) {
+        return false;
+    }
+    const uint32_t* table = slots();
+    for (uint32_t i = 0; i < h->slotCount; i++) {
+        if (table[i] > h->recordCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Callers hold the lock, so no other process maps the file meanwhile.
+bool ScoreStore::addJournal() {
+    size_t length = storeLength(header()->slotCount, header()->recordCapacity);
+    if (::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+        return false;
+    }
+    ::munmap(base, mappedLength);
+    base = nullptr;
+    if (!map(length)) {
+        return false;
+    }
+    header()->changeCount = 0;
+    header()->version = storeVersion;
+    return true;
+}
+
+void ScoreStore::close() {
+    if (base != nullptr) {
+        ::munmap(base, mappedLength);
+        base = nullptr;
+        mappedLength = 0;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void ScoreStore::flush() {
+    if (base != nullptr) {
+        ::msync(base, mappedLength, MS_SYNC);
+    }
+}
+
+bool ScoreStore::replaced() const {
+    if (base == nullptr) {
+        return true;
+    }
+    struct stat onDisk, mapped;
+    if (::stat(path.c_str(), &onDisk) != 0 || ::fstat(fd, &mapped) != 0) {
+        return true;
+    }
+    return onDisk.st_ino != mapped.st_ino || onDisk.st_dev != mapped.st_dev;
+}
+
+uint32_t ScoreStore::size() const {
+    return base != nullptr ? header()->recordCount : 0;
+}
+
+uint64_t ScoreStore::changeCount() const {
+    return base != nullptr ? header()->changeCount : 0;
+}
+
+uint32_t ScoreStore::changedRecord(uint64_t change) const {
+    return journal()[change % journalLength];
+}
+
+void ScoreStore::noteChange(const ScoreRecord* entry) {
+    Header* h = header();
+    journal()[h->changeCount % journalLength] = static_cast<uint32_t>(entry - records());
+    h->changeCount++;
+}
+
+const ScoreRecord& ScoreStore::record(uint32_t index) const {
+    return records()[index];
+}
+
+uint32_t ScoreStore::slotFor(uint64_t hash, const char* name, size_t length) const {
+    uint32_t mask = header()->slotCount - 1;
+    uint32_t* table = slots();
+    ScoreRecord* entries = records();
+    for (uint32_t slot = static_cast<uint32_t>(hash) & mask;; slot = (slot + 1) & mask) {
+        uint32_t value = table[slot];
+        if (value == 0) {
+            return slot;
+        }
+        const ScoreRecord& entry = entries[value - 1];
+        if (entry.hash == hash && std::strncmp(entry.name, name, length) == 0 && entry.name[length] == '\0') {
+            return slot;
+        }
+    }
+}
+
+int ScoreStore::findIndex(const std::string& name) const {
+    if (base == nullptr) {
+        return -1;
+    }
+    size_t length = clampedLength(name);
+    uint32_t value = slots()[slotFor(hashName(name.data(), length), name.data(), length)];
+    return static_cast<int>(value) - 1;
+}
+
+const ScoreRecord* ScoreStore::find(const std::string& name) const {
+    int index = findIndex(name);
+    return index >= 0 ? &records()[index] : nullptr;
+}
+
+ScoreRecord* ScoreStore::insert(const std::string& name) {
+    if (header()->recordCount == header()->recordCapacity && !grow()) {
+        return nullptr;
+    }
+    size_t length = clampedLength(name);
+    uint64_t hash = hashName(name.data(), length);
+    uint32_t slot = slotFor(hash, name.data(), length);
+    uint32_t index = header()->recordCount++;
+    ScoreRecord& entry = records()[index];
+    std::memset(&entry, 0, sizeof(entry));
+    entry.hash = hash;
+    std::memcpy(entry.name, name.data(), length);
+    slots()[slot] = index + 1;
+    return &entry;
+}
+
+bool ScoreStore::grow() {
+    std::string target = path;
+    std::string temp = path + ".tmp";
+    if (!create(temp, header()->recordCapacity * 2)) {
+        return false;
+    }
+    {
+        ScoreStore next;
+        if (!next.open(temp)) {
+            ::unlink(temp.c_str());
+            return false;
+        }
+        for (uint32_t i = 0; i < size(); i++) {
+            const ScoreRecord& old = records()[i];
+            ScoreRecord* moved = next.insert(old.name);
+            moved->bestScore = old.bestScore;
+            moved->gamesPlayed = old.gamesPlayed;
+        }
+        // Records keep their indices, so the journal carries over as is.
+        std::memcpy(next.journal(), journal(), journalLength * sizeof(uint32_t));
+        next.header()->changeCount = header()->changeCount;
+        next.flush();
+    }
+    if (::rename(temp.c_str(), target.c_str()) != 0) {
+        ::unlink(temp.c_str());
+        return false;
+    }
+    return open(target);
+}
+
+int ScoreStore::recordGame(const std::string& name, int tries) {
+    if (base == nullptr || readOnly) {
+        return tries;
+    }
+    int index = findIndex(name);
+    ScoreRecord* entry = index >= 0 ? &records()[index] : insert(name);
+    if (entry == nullptr) {
+        return tries;
+    }
+    if (entry->gamesPlayed == 0) {
+        entry->bestScore = tries;
+    } else if (tries < entry->bestScore || entry->bestScore == 0) {
+        entry->bestScore = tries;
+    }
+    entry->gamesPlayed++;
+    noteChange(entry);
+    return entry->bestScore;
+}
+
+void ScoreStore::put(const ScoreEntry& value) {
+    if (base == nullptr || readOnly) {
+        return;
+    }
+    int index = findIndex(value.name);
+    ScoreRecord* entry = index >= 0 ? &records()[index] : insert(value.name);
+    if (entry != nullptr) {
+        entry->bestScore = value.bestScore;
+        entry->gamesPlayed = value.gamesPlayed;
+        noteChange(entry);
+    }
+}
+
+ScoreStoreLock::~ScoreStoreLock() {
+    close();
+}
+
+bool ScoreStoreLock::open(const std::string& storePath) {
+    close();
+    fd = ::open((storePath + ".lock").c_str(), O_RDWR | O_CREAT, 0644);
+    return fd >= 0;
+}
+
+void ScoreStoreLock::close() {
+    if (fd >= 0) {
+        unlock();
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool ScoreStoreLock::lock() {
+    if (fd < 0) {
+        return false;
+    }
+    while (::flock(fd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+    held = true;
+    return true;
+}
+
+void ScoreStoreLock::unlock() {
+    if (held) {
+        ::flock(fd, LOCK_UN);
+        held = false;
+    }
+}
+
+// A non-negative int followed by `end` (trailing spaces and a CR allowed).
+static bool parseCount(const char* text, char end, int& value) {
+    char* after = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text, &after, 10);
+    if (after == text || errno != 0 || parsed < 0 || parsed > INT32_MAX) {
+        return false;
+    }
+    while (*after == ' ' || *after == '\r') {
+        after++;
+    }
+    if (*after != end) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+bool importScoreboardCsv(const std::string& csvPath, ScoreStore& store) {
+    std::ifstream file(csvPath);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t pos = line.find(',');
+        if (pos != std::string::npos) {
+            std::string name = line.substr(0, pos);
+            size_t pos2 = line.find(',', pos + 1);
+            int bestScore = 0;
+            int gamesPlayed = 0;
+            // Hand-edited legacy files: a line that does not parse is skipped.
+            if (pos2 != std::string::npos && parseCount(line.c_str() + pos + 1, ',', bestScore) &&
+                parseCount(line.c_str() + pos2 + 1, '\0', gamesPlayed)) {
+                store.put({name, bestScore, gamesPlayed});
+            }
+        }
+    }
+    store.flush();
+    return true;
+}
+
+bool exportScoreboardCsv(const ScoreStore& store, const std::string& csvPath) {
+    std::ofstream file(csvPath);
+    if (!file) {
+        return false;
+    }
+    for (uint32_t i = 0; i < store.size(); i++) {
+        const ScoreRecord& entry = store.record(i);
+        file << entry.name << "," << entry.bestScore << "," << entry.gamesPlayed << "\n";
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct ScoreEntry {
+    std::string name;
+    int bestScore;
+    int gamesPlayed;
+};
+
+struct ScoreRecord {
+    uint64_t hash;
+    int32_t bestScore;
+    int32_t gamesPlayed;
+    char name[80];
+};
+
+// Memory-mapped scoreboard: a fixed header, an open-addressing index of
+// name hashes, an array of fixed-size records and a ring journal of the
+// records each update touched. Records are updated in place; the file is
+// only rewritten when the index has to grow.
+class ScoreStore {
+public:
+    static constexpr size_t maxNameLength = sizeof(ScoreRecord::name) - 1;
+    static constexpr uint32_t journalLength = 4096;
+
+    ScoreStore() = default;
+    ~ScoreStore();
+    ScoreStore(const ScoreStore&) = delete;
+    ScoreStore& operator=(const ScoreStore&) = delete;
+
+    // Creates the file when it is missing or empty.
+    bool open(const std::string& path);
+    // For readers such as the export tool: never creates the file and
+    // ignores recordGame() and put().
+    bool openReadOnly(const std::string& path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+    void flush();
+    // True when the file at the store's path is no longer the one mapped:
+    // another process grew it (growth renames a new file over the old) or
+    // removed it. Reopen before writing, with the lock held.
+    bool replaced() const;
+
+    uint32_t size() const;
+    const ScoreRecord& record(uint32_t index) const;
+    // Updates made so far by any process. A reader that last saw `seen`
+    // can visit just the records changed since with changedRecord(), as
+    // long as changeCount() - seen <= journalLength; otherwise the
+    // journal has wrapped and it has to look at every record.
+    uint64_t changeCount() const;
+    uint32_t changedRecord(uint64_t change) const;
+    const ScoreRecord* find(const std::string& name) const;
+    int findIndex(const std::string& name) const;
+
+    // Adds one finished game for `name` and returns the resulting best score.
+    int recordGame(const std::string& name, int tries);
+    // Overwrites or inserts a full entry, used by the CSV importer.
+    void put(const ScoreEntry& entry);
+
+    static uint64_t hashName(const char* name, size_t length);
+
+    struct Header;
+
+private:
+    Header* header() const;
+    uint32_t* slots() const;
+    ScoreRecord* records() const;
+    uint32_t* journal() const;
+    void noteChange(const ScoreRecord* entry);
+    bool addJournal();
+    uint32_t slotFor(uint64_t hash, const char* name, size_t length) const;
+    ScoreRecord* insert(const std::string& name);
+    bool map(size_t length);
+    bool attach();
+    bool valid() const;
+    bool create(const std::string& target, uint32_t recordCapacity);
+    bool grow();
+
+    std::string path;
+    int fd = -1;
+    bool readOnly = false;
+    unsigned char* base = nullptr;
+    size_t mappedLength = 0;
+};
+
+// Exclusive advisory lock for every process writing the store at a path.
+// It is taken on a side file because the store itself is replaced when it
+// grows. The file stays open between lock() calls so writers that lock
+// often do no path work.
+class ScoreStoreLock {
+public:
+    ScoreStoreLock() = default;
+    ~ScoreStoreLock();
+    ScoreStoreLock(const ScoreStoreLock&) = delete;
+    ScoreStoreLock& operator=(const ScoreStoreLock&) = delete;
+
+    bool open(const std::string& storePath);
+    void close();
+    // Blocks until no other process holds the lock.
+    bool lock();
+    void unlock();
+
+private:
+    int fd = -1;
+    bool held = false;
+};
+
+bool importScoreboardCsv(const std::string& csvPath, ScoreStore& store);
+bool exportScoreboardCsv(const ScoreStore& store, const std::string& csvPath);
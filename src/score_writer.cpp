@@ -0,0 +1,281 @@
+#include "score_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const size_t popBatch = 32;
+// A batch that cannot be written is retried at this pace.
+static const int retryMs = 1000;
+// How often the writer looks for games other processes wrote.
+static const int pollMs = 1000;
+
+bool parseFsyncPolicy(const char* text, FsyncPolicy& policy) {
+    if (std::strcmp(text, "never") == 0) {
+        policy = FsyncPolicy::Never;
+    } else if (std::strcmp(text, "batch") == 0) {
+        policy = FsyncPolicy::EveryBatch;
+    } else if (std::strcmp(text, "interval") == 0) {
+        policy = FsyncPolicy::Interval;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+ScoreWriter::ScoreWriter(size_t ringCapacity) : ring(ringCapacity), merged(ringCapacity) {
+}
+
+ScoreWriter::~ScoreWriter() {
+    close();
+}
+
+bool ScoreWriter::open(const std::string& storePath, const ScoreWriterOptions& writerOptions, Leaderboard& view,
+    const char* importCsv) {
+    close();
+    path = storePath;
+    options = writerOptions;
+    if (!lock.open(path) || !lock.lock()) {
+        lock.close();
+        return false;
+    }
+    if (!store.open(path)) {
+        lock.close();
+        return false;
+    }
+    if (importCsv != nullptr && store.size() == 0) {
+        importScoreboardCsv(importCsv, store);
+    }
+    view.build(store);
+    seen.clear();
+    seen.reserve(store.size() + ring.capacity());
+    for (uint32_t i = 0; i < store.size(); i++) {
+        seen.emplace_back(store.record(i).bestScore, store.record(i).gamesPlayed);
+    }
+    lastChange = store.changeCount();
+    rescan = false;
+    lock.unlock();
+    pending.reserve(ring.capacity());
+    mergedName.reserve(ScoreStore::maxNameLength);
+    scratchName.reserve(ScoreStore::maxNameLength);
+    lastSync = std::chrono::steady_clock::now();
+    running.store(true);
+    worker = std::thread(&ScoreWriter::writeLoop, this);
+    return true;
+}
+
+void ScoreWriter::close() {
+    if (!worker.joinable()) {
+        return;
+    }
+    running.store(false);
+    worker.join();
+    store.close();
+    lock.close();
+}
+
+void ScoreWriter::recordGame(const std::string& player, int tries) {
+    if (!worker.joinable()) {
+        return;
+    }
+    Update update = {};
+    update.tries = tries;
+    std::memcpy(update.name, player.data(), std::min(player.size(), ScoreStore::maxNameLength));
+    if (ring.push(&update, 1) != 1) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint32_t depth = queued.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (depth > maxQueued.load(std::memory_order_relaxed)) {
+        maxQueued.store(depth, std::memory_order_relaxed);
+    }
+}
+
+size_t ScoreWriter::applyMerged(Leaderboard& view) {
+    Merged record;
+    size_t applied = 0;
+    while (merged.pop(&record, 1) == 1) {
+        mergedName.assign(record.name);
+        int id = view.findId(mergedName);
+        if (id < 0) {
+            view.update(view.size(), {mergedName, record.bestScore, record.gamesPlayed});
+            applied++;
+            continue;
+        }
+        // Both sides only grow: games not yet written here are in the view
+        // but not the file, other kiosks' games the other way round.
+        const ScoreEntry& local = view.entry(id);
+        int games = std::max(local.gamesPlayed, record.gamesPlayed);
+        int best = local.bestScore == 0 ? record.bestScore :
+            record.bestScore == 0 ? local.bestScore : std::min(local.bestScore, record.bestScore);
+        if (games != local.gamesPlayed || best != local.bestScore) {
+            view.update(static_cast<uint32_t>(id), {mergedName, best, games});
+            applied++;
+        }
+    }
+    return applied;
+}
+
+ScoreWriterStats ScoreWriter::stats() const {
+    uint64_t written = batches.load(std::memory_order_relaxed);
+    ScoreWriterStats result = {};
+    result.games = games.load(std::memory_order_relaxed);
+    result.dropped = dropped.load(std::memory_order_relaxed);
+    result.batches = written;
+    result.failures = failures.load(std::memory_order_relaxed);
+    result.reopens = reopens.load(std::memory_order_relaxed);
+    result.merged = mergedCount.load(std::memory_order_relaxed);
+    result.queueDepth = queued.load(std::memory_order_relaxed);
+    result.maxQueueDepth = maxQueued.load(std::memory_order_relaxed);
+    result.writeAvgMs = written > 0 ? writeTotalUs.load(std::memory_order_relaxed) / 1000.0 / written : 0.0;
+    result.writeMaxMs = writeMaxUs.load(std::memory_order_relaxed) / 1000.0;
+    return result;
+}
+
+void ScoreWriter::writeLoop() {
+    Update batch[popBatch];
+    auto firstPending = std::chrono::steady_clock::now();
+    auto retryAt = firstPending;
+    auto lastPoll = firstPending;
+    for (;;) {
+        // Read the flag before draining so no game recorded before close()
+        // is left in the ring.
+        bool stopping = !running.load();
+        size_t got;
+        while ((got = ring.pop(batch, popBatch)) > 0) {
+            if (pending.empty()) {
+                firstPending = std::chrono::steady_clock::now();
+            }
+            pending.insert(pending.end(), batch, batch + got);
+        }
+        auto now = std::chrono::steady_clock::now();
+        bool due = now - firstPending >= std::chrono::milliseconds(options.batchMs) && now >= retryAt;
+        if (!pending.empty() && (stopping || due)) {
+            bool written = writeBatch();
+            if (!written) {
+                retryAt = now + std::chrono::milliseconds(retryMs);
+            }
+            if (written || stopping) {
+                if (!written) {
+                    dropped.fetch_add(pending.size(), std::memory_order_relaxed);
+                }
+                queued.fetch_sub(static_cast<uint32_t>(pending.size()), std::memory_order_relaxed);
+                pending.clear();
+            }
+            lastPoll = now;
+        } else if (!stopping && now - lastPoll >= std::chrono::milliseconds(pollMs)) {
+            poll();
+            lastPoll = now;
+        } else if (options.fsync == FsyncPolicy::Interval && now - lastSync >= std::chrono::milliseconds(options.fsyncIntervalMs)) {
+            store.flush();
+            lastSync = now;
+        }
+        if (stopping) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    if (options.fsync == FsyncPolicy::Interval) {
+        store.flush();
+    }
+}
+
+bool ScoreWriter::writeBatch() {
+    auto start = std::chrono::steady_clock::now();
+    if (!lock.lock()) {
+        failures.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (store.replaced()) {
+        reopens.fetch_add(1, std::memory_order_relaxed);
+        rescan = true;
+        if (!store.open(path)) {
+            lock.unlock();
+            failures.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    for (const Update& update : pending) {
+        scratchName.assign(update.name);
+        store.recordGame(scratchName, update.tries);
+    }
+    if (options.fsync == FsyncPolicy::EveryBatch) {
+        store.flush();
+        lastSync = std::chrono::steady_clock::now();
+    }
+    collectMerged();
+    lock.unlock();
+    uint64_t us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    games.fetch_add(pending.size(), std::memory_order_relaxed);
+    batches.fetch_add(1, std::memory_order_relaxed);
+    writeTotalUs.fetch_add(us, std::memory_order_relaxed);
+    if (us > writeMaxUs.load(std::memory_order_relaxed)) {
+        writeMaxUs.store(us, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool ScoreWriter::poll() {
+    if (!lock.lock()) {
+        return false;
+    }
+    bool ok = true;
+    if (store.replaced()) {
+        reopens.fetch_add(1, std::memory_order_relaxed);
+        rescan = true;
+        ok = store.open(path);
+    }
+    if (ok) {
+        collectMerged();
+    }
+    lock.unlock();
+    return ok;
+}
+
+// Lock held. Walks the store's change journal from the last update seen,
+// so a pass costs the number of updates since, not the number of players.
+// Only when the journal wrapped or the file was replaced by one that may
+// not share its history does it compare every record. A record that does
+// not fit in the ring is sent again on the next pass.
+void ScoreWriter::collectMerged() {
+    uint32_t count = store.size();
+    if (seen.size() < count) {
+        seen.resize(count, {0, 0});
+    }
+    uint64_t latest = store.changeCount();
+    if (rescan || latest < lastChange || latest - lastChange > ScoreStore::journalLength) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (!sendMerged(i)) {
+                return;
+            }
+        }
+        rescan = false;
+        lastChange = latest;
+        return;
+    }
+    for (; lastChange < latest; lastChange++) {
+        uint32_t index = store.changedRecord(lastChange);
+        if (index < count && !sendMerged(index)) {
+            return;
+        }
+    }
+}
+
+bool ScoreWriter::sendMerged(uint32_t index) {
+    const ScoreRecord& record = store.record(index);
+    std::pair<int32_t, int32_t>& last = seen[index];
+    if (last.first == record.bestScore && last.second == record.gamesPlayed) {
+        return true;
+    }
+    Merged update = {};
+    update.bestScore = record.bestScore;
+    update.gamesPlayed = record.gamesPlayed;
+    std::memcpy(update.name, record.name, sizeof(update.name));
+    update.name[ScoreStore::maxNameLength] = '\0';
+    if (merged.push(&update, 1) != 1) {
+        return false;
+    }
+    last = {record.bestScore, record.gamesPlayed};
+    mergedCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "leaderboard.h"
+#include "score_store.h"
+#include "spsc_ring.h"
+
+// When finished batches are forced to disk. Without a sync they are still
+// in the page cache, safe from a crash of the game but not of the machine.
+enum class FsyncPolicy {
+    Never,
+    EveryBatch,
+    Interval
+};
+
+// "never", "batch" or "interval", as command lines spell it.
+bool parseFsyncPolicy(const char* text, FsyncPolicy& policy);
+
+struct ScoreWriterOptions {
+    FsyncPolicy fsync = FsyncPolicy::EveryBatch;
+    // How long the first game of a batch waits for others to join it.
+    int batchMs = 250;
+    // Sync period for FsyncPolicy::Interval.
+    int fsyncIntervalMs = 5000;
+};
+
+struct ScoreWriterStats {
+    uint64_t games;
+    uint64_t dropped;
+    uint64_t batches;
+    uint64_t failures;
+    // Times another process had replaced the store since the last batch.
+    uint64_t reopens;
+    // Records sent back to the caller's view because the file changed.
+    uint64_t merged;
+    uint32_t queueDepth;
+    uint32_t maxQueueDepth;
+    double writeAvgMs;
+    double writeMaxMs;
+};
+
+// Write-behind persistence for finished games. recordGame() copies the
+// result into a lock-free ring and returns; a writer thread collects a
+// batch, takes the store's file lock, reopens the store if another process
+// replaced it, adds each game with ScoreStore::recordGame and syncs as the
+// policy says. Because every process merges games one by one under the
+// lock, kiosks sharing a store add up instead of overwriting each other.
+// While it holds the lock after a batch, and once a second otherwise, the
+// writer also follows the store's change journal to the records updated
+// since it last looked, by this process or any other, for applyMerged()
+// to hand to the view.
+class ScoreWriter {
+public:
+    explicit ScoreWriter(size_t ringCapacity = 256);
+    ~ScoreWriter();
+    ScoreWriter(const ScoreWriter&) = delete;
+    ScoreWriter& operator=(const ScoreWriter&) = delete;
+
+    // Opens the store under the lock, imports `importCsv` into it when
+    // given and builds `view` from it before the writer thread starts.
+    // Afterwards only the writer thread touches the store; callers keep
+    // `view` current with Leaderboard::recordGame and applyMerged().
+    bool open(const std::string& path, const ScoreWriterOptions& options, Leaderboard& view,
+        const char* importCsv = nullptr);
+    // Writes out everything pending and stops the writer thread.
+    void close();
+    bool isOpen() const { return worker.joinable(); }
+
+    void recordGame(const std::string& name, int tries);
+    // Same thread as recordGame(). Merges the records the file holds now
+    // into `view` (most games, lowest best score) and returns how many
+    // entries changed.
+    size_t applyMerged(Leaderboard& view);
+    ScoreWriterStats stats() const;
+
+private:
+    struct Update {
+        int32_t tries;
+        char name[ScoreStore::maxNameLength + 1];
+    };
+
+    struct Merged {
+        int32_t bestScore;
+        int32_t gamesPlayed;
+        char name[ScoreStore::maxNameLength + 1];
+    };
+
+    void writeLoop();
+    bool writeBatch();
+    bool poll();
+    void collectMerged();
+    bool sendMerged(uint32_t index);
+
+    ScoreStore store;
+    ScoreStoreLock lock;
+    std::string path;
+    std::string scratchName;
+    ScoreWriterOptions options;
+    SpscRing<Update> ring;
+    std::vector<Update> pending;
+    SpscRing<Merged> merged;
+    // Best score and games of each store record as last sent back.
+    std::vector<std::pair<int32_t, int32_t>> seen;
+    // Store change count collectMerged() has caught up to.
+    uint64_t lastChange = 0;
+    bool rescan = false;
+    std::string mergedName;
+    std::chrono::steady_clock::time_point lastSync;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> games{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> batches{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> reopens{0};
+    std::atomic<uint64_t> mergedCount{0};
+    std::atomic<uint32_t> queued{0};
+    std::atomic<uint32_t> maxQueued{0};
+    std::atomic<uint64_t> writeTotalUs{0};
+    std::atomic<uint64_t> writeMaxUs{0};
+};
@@ -0,0 +1,59 @@
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include "score_store.h"
+
+static void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "Uso: %s import <scoreboard.txt> <scoreboard.bin>\n"
+        "     %s export <scoreboard.bin> <scoreboard.txt>\n",
+        program, program);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4 || (std::strcmp(argv[1], "import") != 0 && std::strcmp(argv[1], "export") != 0)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    // Games finished while the tool runs wait for the lock and are merged
+    // afterwards instead of being lost.
+    const char* storePath = std::strcmp(argv[1], "import") == 0 ? argv[3] : argv[2];
+    // Export only reads: a missing store is an error, not a new empty one,
+    // and leaves no lock file behind.
+    if (storePath == argv[2] && ::access(storePath, F_OK) != 0) {
+        std::fprintf(stderr, "Nao foi possivel abrir %s\n", storePath);
+        return 1;
+    }
+    ScoreStoreLock lock;
+    if (!lock.open(storePath) || !lock.lock()) {
+        std::fprintf(stderr, "Nao foi possivel travar %s\n", storePath);
+        return 1;
+    }
+    ScoreStore store;
+    if (std::strcmp(argv[1], "import") == 0) {
+        if (!store.open(argv[3])) {
+            std::fprintf(stderr, "Nao foi possivel abrir %s\n", argv[3]);
+            return 1;
+        }
+        if (!importScoreboardCsv(argv[2], store)) {
+            std::fprintf(stderr, "Nao foi possivel ler %s\n", argv[2]);
+            return 1;
+        }
+        std::printf("%u jogadores em %s\n", store.size(), argv[3]);
+        return 0;
+    }
+    if (std::strcmp(argv[1], "export") == 0) {
+        if (!store.openReadOnly(argv[2])) {
+            std::fprintf(stderr, "Nao foi possivel abrir %s\n", argv[2]);
+            return 1;
+        }
+        if (!exportScoreboardCsv(store, argv[3])) {
+            std::fprintf(stderr, "Nao foi possivel escrever %s\n", argv[3]);
+            return 1;
+        }
+        std::printf("%u jogadores em %s\n", store.size(), argv[3]);
+        return 0;
+    }
+    printUsage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "event_log.h"
+#include "game.h"
+#include "rng.h"
+#include "strategy.h"
+
+enum class Strategy {
+    Random,
+    Binary,
+    Leftmost,
+    Optimal
+};
+
+struct SimOptions {
+    long long games = 1000000;
+    int players = 2;
+    int maxNumber = 6;
+    int threads = 0;
+    uint64_t seed = 0;
+    bool seeded = false;
+    const char* eventsPath = nullptr;
+    Strategy strategy = Strategy::Binary;
+};
+
+struct SimStats {
+    long long games = 0;
+    long long ties = 0;
+    long long turns = 0;
+    long long totalTries = 0;
+    std::vector<long long> triesHistogram;
+    std::vector<long long> winningTriesHistogram;
+};
+
+static const char* strategyName(Strategy strategy) {
+    switch (strategy) {
+        case Strategy::Random: return "random";
+        case Strategy::Binary: return "binary";
+        case Strategy::Leftmost: return "leftmost";
+        case Strategy::Optimal: return "optimal";
+    }
+    return "?";
+}
+
+static bool parseStrategy(const char* text, Strategy& strategy) {
+    for (Strategy s : {Strategy::Random, Strategy::Binary, Strategy::Leftmost, Strategy::Optimal}) {
+        if (std::strcmp(text, strategyName(s)) == 0) {
+            strategy = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int pickGuess(Strategy strategy, const GameSession& session, const StrategyTable& table, Rng& rng) {
+    switch (strategy) {
+        case Strategy::Random:
+            return rng.uniform(session.lowerBound, session.upperBound);
+        case Strategy::Binary:
+            return session.lowerBound + (session.upperBound - session.lowerBound) / 2;
+        case Strategy::Leftmost:
+            return session.lowerBound;
+        case Strategy::Optimal:
+            return table.bestGuess(session.lowerBound, session.upperBound);
+    }
+    return session.lowerBound;
+}
+
+static const long long gamesPerBatch = 4096;
+
+// Gives simulated guesses a plausible time base so the event log has
+// something for dice_stats to aggregate.
+static void logGuess(EventLogWriter& events, const GameSession& session, const Player& player, int lower, int upper,
+    int guess, GuessResult result, Rng& rng, uint64_t& clockMs) {
+    GuessEvent event = makeGuessEvent(player.name, false);
+    event.thinkMs = static_cast<uint32_t>(rng.uniform(300, 4000));
+    clockMs += event.thinkMs;
+    event.timeMs = clockMs;
+    event.maxNumber = session.maxNumber;
+    event.lowerBound = lower;
+    event.upperBound = upper;
+    event.guess = guess;
+    event.tries = player.tries;
+    event.result = static_cast<uint8_t>(result);
+    while (!events.tryAppend(event)) {
+        std::this_thread::yield();
+    }
+}
+
+static void runGames(const SimOptions& options, const StrategyTable& table, long long games, Rng rng, SimStats& stats,
+    EventLogWriter* events) {
+    std::vector<int> targets(static_cast<size_t>(gamesPerBatch * options.players));
+    size_t nextTarget = targets.size();
+    stats.triesHistogram.assign(options.maxNumber + 1, 0);
+    stats.winningTriesHistogram.assign(options.maxNumber + 1, 0);
+
+    GameSession session;
+    session.maxNumber = options.maxNumber;
+    for (int i = 0; i < options.players; i++) {
+        session.players.push_back({"Jogador " + std::to_string(i + 1), 0, 0});
+    }
+
+    uint64_t clockMs = eventClockMs();
+    for (long long g = 0; g < games; g++) {
+        if (nextTarget + options.players > targets.size()) {
+            rng.fillTargets(targets.data(), targets.size(), options.maxNumber);
+            nextTarget = 0;
+        }
+        session.reset();
+        session.beginTurn(targets[nextTarget++]);
+        while (!session.finished) {
+            int player = session.currentPlayer;
+            int lower = session.lowerBound;
+            int upper = session.upperBound;
+            int guess = pickGuess(options.strategy, session, table, rng);
+            GuessResult result = session.guess(guess);
+            if (events != nullptr) {
+                logGuess(*events, session, session.players[player], lower, upper, guess, result, rng, clockMs);
+            }
+            if (result == GuessResult::Correct || result == GuessResult::GameOver) {
+                int tries = session.players[player].tries;
+                stats.triesHistogram[std::min(tries, options.maxNumber)]++;
+                stats.totalTries += tries;
+                stats.turns++;
+                if (result == GuessResult::Correct) {
+                    session.beginTurn(targets[nextTarget++]);
+                }
+            }
+        }
+        GameOutcome outcome = session.outcome();
+        stats.winningTriesHistogram[std::min(outcome.minTries, options.maxNumber)]++;
+        if (outcome.winners > 1) {
+            stats.ties++;
+        }
+        stats.games++;
+    }
+}
+
+static void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "Uso: %s [--games N] [--players N] [--max N] [--threads N] [--seed N] [--strategy random|binary|leftmost|optimal]\n"
+        "       [--events <arquivo>]  grava cada jogada (usa uma thread)\n",
+        program);
+}
+
+int main(int argc, char** argv) {
+    SimOptions options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (std::strcmp(arg, "--games") == 0) {
+            options.games = std::atoll(value);
+        } else if (std::strcmp(arg, "--players") == 0) {
+            options.players = std::atoi(value);
+        } else if (std::strcmp(arg, "--max") == 0) {
+            options.maxNumber = std::atoi(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+            options.seeded = true;
+        } else if (std::strcmp(arg, "--events") == 0) {
+            options.eventsPath = value;
+        } else if (std::strcmp(arg, "--strategy") == 0) {
+            if (!parseStrategy(value, options.strategy)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (options.games <= 0 || options.players <= 0 || options.maxNumber <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    // The log has a single producer, so --events runs one thread. Its ring
+    // is large, so it only exists when there is a log to write.
+    std::unique_ptr<EventLogWriter> events;
+    if (options.eventsPath != nullptr) {
+        if (options.threads > 1) {
+            std::fprintf(stderr, "--events grava com uma thread; ignorando --threads %d\n", options.threads);
+        }
+        options.threads = 1;
+        events.reset(new EventLogWriter(64 * 1024));
+        if (!events->open(options.eventsPath)) {
+            std::fprintf(stderr, "Nao foi possivel abrir %s\n", options.eventsPath);
+            return 1;
+        }
+    }
+    if (options.threads <= 0) {
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (!options.seeded) {
+        std::random_device rd;
+        options.seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+    StrategyTable table;
+    table.build(options.maxNumber);
+    Rng rng(options.seed);
+    std::vector<SimStats> perThread(options.threads);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < options.threads; t++) {
+        long long share = options.games / options.threads + (t < options.games % options.threads ? 1 : 0);
+        EventLogWriter* log = events.get();
+        workers.emplace_back([&options, &table, &perThread, log, share, rng, t]() {
+            runGames(options, table, share, rng, perThread[t], log);
+        });
+        rng.jump();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (events) {
+        events->close();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    SimStats total;
+    total.triesHistogram.assign(options.maxNumber + 1, 0);
+    total.winningTriesHistogram.assign(options.maxNumber + 1, 0);
+    for (const auto& stats : perThread) {
+        total.games += stats.games;
+        total.ties += stats.ties;
+        total.turns += stats.turns;
+        total.totalTries += stats.totalTries;
+        for (int i = 0; i <= options.maxNumber; i++) {
+            total.triesHistogram[i] += stats.triesHistogram[i];
+            total.winningTriesHistogram[i] += stats.winningTriesHistogram[i];
+        }
+    }
+
+    std::printf("estrategia: %s  semente: %llu\n", strategyName(options.strategy),
+        static_cast<unsigned long long>(options.seed));
+    std::printf("jogos: %lld  jogadores: %d  maxNumber: %d  threads: %d\n",
+        total.games, options.players, options.maxNumber, options.threads);
+    std::printf("tempo: %.3f s (%.0f jogos/s)\n", seconds, seconds > 0 ? total.games / seconds : 0.0);
+    std::printf("tentativas medias por turno: %.4f\n",
+        total.turns > 0 ? static_cast<double>(total.totalTries) / total.turns : 0.0);
+    std::printf("tentativas esperadas (estrategia otima): %.4f\n", table.expectedTries(1, options.maxNumber));
+    if (events) {
+        EventLogStats eventStats = events->stats();
+        std::printf("eventos: %llu em %llu blocos, %llu bytes (%.2f bytes/jogada)\n",
+            static_cast<unsigned long long>(eventStats.events), static_cast<unsigned long long>(eventStats.blocks),
+            static_cast<unsigned long long>(eventStats.bytes),
+            eventStats.events > 0 ? static_cast<double>(eventStats.bytes) / eventStats.events : 0.0);
+    }
+    std::printf("taxa de empate: %.4f%%\n",
+        total.games > 0 ? 100.0 * total.ties / total.games : 0.0);
+    std::printf("tentativas  turnos        %%       vencedor      %%\n");
+    for (int i = 1; i <= options.maxNumber; i++) {
+        if (total.triesHistogram[i] == 0 && total.winningTriesHistogram[i] == 0) {
+            continue;
+        }
+        std::printf("%10d  %12lld  %6.2f  %12lld  %6.2f\n", i,
+            total.triesHistogram[i], 100.0 * total.triesHistogram[i] / total.turns,
+            total.winningTriesHistogram[i], 100.0 * total.winningTriesHistogram[i] / total.games);
+    }
+    return 0;
+}
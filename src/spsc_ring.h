@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded single-producer/single-consumer ring. The producer only writes
+// `tail` and the consumer only writes `head`; each side reads the other's
+// index with acquire order, so no locks are needed. Capacity is rounded up
+// to a power of two.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        items.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    size_t capacity() const { return items.size(); }
+
+    size_t readable() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+    }
+
+    size_t writable() const {
+        return capacity() - (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire));
+    }
+
+    // Producer side. Returns how many items were copied.
+    size_t push(const T* values, size_t count) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t room = capacity() - (t - head.load(std::memory_order_acquire));
+        if (count > room) {
+            count = room;
+        }
+        for (size_t i = 0; i < count; i++) {
+            items[(t + i) & mask] = values[i];
+        }
+        tail.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side. Returns how many items were copied.
+    size_t pop(T* out, size_t count) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t available = tail.load(std::memory_order_acquire) - h;
+        if (count > available) {
+            count = available;
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[i] = items[(h + i) & mask];
+        }
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<T> items;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "event_log.h"
+#include "game.h"
+#include "strategy.h"
+
+enum class Who {
+    Everyone,
+    Humans,
+    Bots
+};
+
+struct StatsOptions {
+    const char* path = nullptr;
+    const char* player = nullptr;
+    Who who = Who::Everyone;
+    int top = 20;
+};
+
+// Think times in log-linear buckets: exact below 16 ms, then eight
+// buckets per power of two (about 12% wide).
+static const size_t thinkBuckets = 16 + 28 * 8;
+// Tries per turn above this land in the last histogram row.
+static const int maxTriesRow = 40;
+
+static size_t thinkBucket(uint32_t ms) {
+    if (ms < 16) {
+        return ms;
+    }
+    int exponent = 31 - __builtin_clz(ms);
+    return 16 + static_cast<size_t>(exponent - 4) * 8 + ((ms >> (exponent - 3)) & 7);
+}
+
+// Midpoint of the bucket, what percentiles report.
+static uint32_t thinkBucketValue(size_t bucket) {
+    if (bucket < 16) {
+        return static_cast<uint32_t>(bucket);
+    }
+    int shift = static_cast<int>((bucket - 16) / 8) + 1;
+    return static_cast<uint32_t>(((8 + (bucket - 16) % 8) << shift) + (1u << shift) / 2);
+}
+
+struct ThinkHistogram {
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint32_t maxMs = 0;
+
+    void add(uint32_t ms) {
+        if (counts.empty()) {
+            counts.assign(thinkBuckets, 0);
+        }
+        counts[thinkBucket(ms)]++;
+        total++;
+        maxMs = std::max(maxMs, ms);
+    }
+
+    uint32_t percentile(double fraction) const {
+        uint64_t wanted = static_cast<uint64_t>(total * fraction);
+        uint64_t seen = 0;
+        for (size_t b = 0; b < counts.size(); b++) {
+            seen += counts[b];
+            if (seen > wanted) {
+                return std::min(thinkBucketValue(b), maxMs);
+            }
+        }
+        return maxMs;
+    }
+};
+
+struct PlayerStats {
+    std::string name;
+    bool bot = false;
+    uint64_t guesses = 0;
+    uint64_t turns = 0;
+    uint64_t triesTotal = 0;
+    double bits = 0.0;
+    double optimalTries = 0.0;
+    ThinkHistogram think;
+};
+
+// Information a guess gained, in bits: how much it shrank the window.
+static double guessBits(int32_t lower, int32_t upper, int32_t guess, uint8_t result) {
+    double before = static_cast<double>(upper) - lower + 1;
+    double after = before;
+    if (guess < lower || guess > upper) {
+        return 0.0;
+    }
+    if (result == static_cast<uint8_t>(GuessResult::Higher)) {
+        after = static_cast<double>(upper) - guess;
+    } else if (result == static_cast<uint8_t>(GuessResult::Lower)) {
+        after = static_cast<double>(guess) - lower;
+    } else {
+        after = 1.0;
+    }
+    return after > 0.0 && before > 0.0 ? std::log2(before / after) : 0.0;
+}
+
+static std::string formatTime(uint64_t ms) {
+    time_t seconds = static_cast<time_t>(ms / 1000);
+    tm local = {};
+    localtime_r(&seconds, &local);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M", &local);
+    return text;
+}
+
+static void printUsage(const char* program) {
+    std::fprintf(stderr, "Uso: %s <events.bin> [--player NOME] [--humans | --bots] [--top N]\n", program);
+}
+
+int main(int argc, char** argv) {
+    StatsOptions options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--humans") == 0) {
+            options.who = Who::Humans;
+        } else if (std::strcmp(arg, "--bots") == 0) {
+            options.who = Who::Bots;
+        } else if (std::strcmp(arg, "--player") == 0 && value != nullptr) {
+            options.player = value;
+            i++;
+        } else if (std::strcmp(arg, "--top") == 0 && value != nullptr) {
+            options.top = std::atoi(value);
+            i++;
+        } else if (arg[0] != '-' && options.path == nullptr) {
+            options.path = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.path == nullptr) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    EventLogReader reader;
+    if (!reader.open(options.path)) {
+        std::fprintf(stderr, "Nao foi possivel ler %s\n", options.path);
+        return 1;
+    }
+
+    // Everything below is a running aggregate; only the current block is
+    // ever decoded in memory.
+    std::vector<PlayerStats> players;
+    std::unordered_map<std::string, uint32_t> playerIds;
+    std::vector<uint32_t> blockPlayers;
+    std::unordered_map<int32_t, std::unique_ptr<StrategyTable>> tables;
+    std::vector<uint64_t> triesHistogram(maxTriesRow + 1, 0);
+    ThinkHistogram think;
+    EventBlock block;
+    uint64_t blocks = 0, events = 0, matched = 0, turns = 0, games = 0, triesTotal = 0;
+    uint64_t firstMs = UINT64_MAX, lastMs = 0;
+    double bits = 0.0, optimalTries = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (reader.next(block)) {
+        blocks++;
+        events += block.size();
+        firstMs = std::min(firstMs, block.header.firstTimeMs);
+        lastMs = std::max(lastMs, block.header.lastTimeMs);
+
+        blockPlayers.assign(block.names.size(), UINT32_MAX);
+        for (size_t n = 0; n < block.names.size(); n++) {
+            if (options.player != nullptr && block.names[n] != options.player) {
+                continue;
+            }
+            auto inserted = playerIds.emplace(block.names[n], static_cast<uint32_t>(players.size()));
+            if (inserted.second) {
+                players.emplace_back();
+                players.back().name = block.names[n];
+            }
+            blockPlayers[n] = inserted.first->second;
+        }
+
+        for (size_t i = 0; i < block.size(); i++) {
+            uint32_t id = blockPlayers[block.player[i]];
+            bool bot = block.bot[i] != 0;
+            if (id == UINT32_MAX || (options.who == Who::Humans && bot) || (options.who == Who::Bots && !bot)) {
+                continue;
+            }
+            matched++;
+            PlayerStats& player = players[id];
+            player.bot = bot;
+            player.guesses++;
+            player.think.add(block.thinkMs[i]);
+            think.add(block.thinkMs[i]);
+            double gained = guessBits(block.lowerBound[i], block.upperBound[i], block.guess[i], block.result[i]);
+            player.bits += gained;
+            bits += gained;
+
+            uint8_t result = block.result[i];
+            if (result != static_cast<uint8_t>(GuessResult::Correct) && result != static_cast<uint8_t>(GuessResult::GameOver)) {
+                continue;
+            }
+            int32_t maxNumber = block.maxNumber[i];
+            std::unique_ptr<StrategyTable>& table = tables[maxNumber];
+            if (!table) {
+                table.reset(new StrategyTable());
+                table->build(std::max(1, maxNumber));
+            }
+            double expected = table->expectedTries(1, std::max(1, maxNumber));
+            int tries = std::max(0, block.tries[i]);
+            triesHistogram[std::min(tries, maxTriesRow)]++;
+            triesTotal += static_cast<uint64_t>(tries);
+            optimalTries += expected;
+            turns++;
+            player.turns++;
+            player.triesTotal += static_cast<uint64_t>(tries);
+            player.optimalTries += expected;
+            if (result == static_cast<uint8_t>(GuessResult::GameOver)) {
+                games++;
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (reader.damaged()) {
+        std::fprintf(stderr, "Aviso: bloco %llu danificado, leitura interrompida\n", static_cast<unsigned long long>(blocks + 1));
+    }
+
+    std::printf("arquivo: %s  blocos: %llu  jogadas: %llu\n", options.path,
+        static_cast<unsigned long long>(blocks), static_cast<unsigned long long>(events));
+    std::printf("leitura: %.3f s (%.0f jogadas/s)\n", seconds, seconds > 0.0 ? events / seconds : 0.0);
+    if (events == 0) {
+        return reader.damaged() ? 1 : 0;
+    }
+    std::printf("periodo: %s a %s\n", formatTime(firstMs).c_str(), formatTime(lastMs).c_str());
+    size_t activePlayers = static_cast<size_t>(std::count_if(players.begin(), players.end(),
+        [](const PlayerStats& player) { return player.guesses > 0; }));
+    std::printf("selecionadas: %llu jogadas  %llu turnos  %llu fins de jogo  %zu jogadores\n",
+        static_cast<unsigned long long>(matched), static_cast<unsigned long long>(turns),
+        static_cast<unsigned long long>(games), activePlayers);
+    if (matched == 0) {
+        return 0;
+    }
+    std::printf("tempo por jogada (ms): p50 %u  p90 %u  p99 %u  max %u\n",
+        think.percentile(0.50), think.percentile(0.90), think.percentile(0.99), think.maxMs);
+    std::printf("bits por jogada: %.3f (busca binaria ~1)\n", bits / matched);
+    if (turns > 0) {
+        std::printf("tentativas por turno: %.3f  otimo: %.3f\n",
+            static_cast<double>(triesTotal) / turns, optimalTries / turns);
+        std::printf("tentativas  turnos        %%\n");
+        for (int t = 1; t <= maxTriesRow; t++) {
+            if (triesHistogram[t] == 0) {
+                continue;
+            }
+            std::printf("%9d%s  %12llu  %6.2f\n", t, t == maxTriesRow ? "+" : " ",
+                static_cast<unsigned long long>(triesHistogram[t]), 100.0 * triesHistogram[t] / turns);
+        }
+    }
+
+    std::sort(players.begin(), players.end(), [](const PlayerStats& a, const PlayerStats& b) {
+        return a.guesses != b.guesses ? a.guesses > b.guesses : a.name < b.name;
+    });
+    size_t shown = std::min(players.size(), static_cast<size_t>(std::max(0, options.top)));
+    if (shown > 0) {
+        std::printf("%-24s %10s %8s %8s %8s %7s %8s %8s\n", "jogador", "jogadas", "turnos", "tent.", "otimo", "bits", "p50 ms", "p90 ms");
+    }
+    for (size_t p = 0; p < shown; p++) {
+        const PlayerStats& player = players[p];
+        if (player.guesses == 0) {
+            break;
+        }
+        std::string label = player.bot ? player.name + " (bot)" : player.name;
+        std::printf("%-24s %10llu %8llu %8.2f %8.2f %7.3f %8u %8u\n", label.c_str(),
+            static_cast<unsigned long long>(player.guesses), static_cast<unsigned long long>(player.turns),
+            player.turns > 0 ? static_cast<double>(player.triesTotal) / player.turns : 0.0,
+            player.turns > 0 ? player.optimalTries / player.turns : 0.0,
+            player.bits / player.guesses, player.think.percentile(0.50), player.think.percentile(0.90));
+    }
+    return reader.damaged() ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+#include "strategy.h"
+
+#include <cstddef>
+
+struct SmallStrategy {
+    uint32_t total[StrategyTable::compileTimeMax + 1];
+    uint32_t offset[StrategyTable::compileTimeMax + 1];
+};
+
+static constexpr int distance(int a, int b) {
+    return a > b ? a - b : b - a;
+}
+
+// Full DP over every split point; ties go to the split nearest the middle.
+static constexpr SmallStrategy buildSmallStrategy() {
+    SmallStrategy table = {};
+    for (int w = 1; w <= StrategyTable::compileTimeMax; w++) {
+        int middle = (w - 1) / 2;
+        uint32_t best = 0xFFFFFFFFu;
+        int bestSplit = 0;
+        for (int k = 0; k < w; k++) {
+            uint32_t cost = table.total[k] + table.total[w - 1 - k];
+            if (cost < best || (cost == best && distance(k, middle) < distance(bestSplit, middle))) {
+                best = cost;
+                bestSplit = k;
+            }
+        }
+        table.total[w] = static_cast<uint32_t>(w) + best;
+        table.offset[w] = static_cast<uint32_t>(bestSplit);
+    }
+    return table;
+}
+
+static constexpr SmallStrategy smallStrategy = buildSmallStrategy();
+
+static constexpr bool balancedSplitIsOptimal() {
+    for (int w = 1; w <= StrategyTable::compileTimeMax; w++) {
+        int left = (w - 1) / 2;
+        if (smallStrategy.offset[w] != static_cast<uint32_t>(left) ||
+            smallStrategy.total[w] != w + smallStrategy.total[left] + smallStrategy.total[w - 1 - left]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(balancedSplitIsOptimal(), "build() relies on the balanced split being optimal");
+static_assert(smallStrategy.total[6] == 14, "d6: 14 tries over six targets");
+
+void StrategyTable::build(int maxNumber) {
+    if (maxNumber <= compileTimeMax || static_cast<size_t>(maxNumber) < totals.size()) {
+        return;
+    }
+    size_t from = totals.empty() ? compileTimeMax + 1 : totals.size();
+    if (totals.empty()) {
+        totals.assign(smallStrategy.total, smallStrategy.total + compileTimeMax + 1);
+    }
+    totals.resize(static_cast<size_t>(maxNumber) + 1);
+    for (size_t w = from; w < totals.size(); w++) {
+        size_t left = (w - 1) / 2;
+        totals[w] = static_cast<uint32_t>(w) + totals[left] + totals[w - 1 - left];
+    }
+}
+
+int StrategyTable::maxNumber() const {
+    return totals.empty() ? compileTimeMax : static_cast<int>(totals.size()) - 1;
+}
+
+uint32_t StrategyTable::total(int width) const {
+    return width <= compileTimeMax ? smallStrategy.total[width] : totals[width];
+}
+
+double StrategyTable::expectedTries(int lowerBound, int upperBound) const {
+    int width = upperBound - lowerBound + 1;
+    if (width <= 0 || width > maxNumber()) {
+        return 0.0;
+    }
+    return static_cast<double>(total(width)) / width;
+}
+
+int StrategyTable::bestGuess(int lowerBound, int upperBound) const {
+    int width = upperBound - lowerBound + 1;
+    if (width <= 0) {
+        return lowerBound;
+    }
+    if (width <= compileTimeMax) {
+        return lowerBound + static_cast<int>(smallStrategy.offset[width]);
+    }
+    return lowerBound + (width - 1) / 2;
+}
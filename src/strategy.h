@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Optimal play for the higher/lower game with a uniform target. After any
+// sequence of hints the target is uniform over the open window, so both
+// the expected number of tries and the best guess depend only on the
+// window width w. The optimum is a balanced search tree: total(w) =
+// w + total(k) + total(w - 1 - k), minimized at k = (w - 1) / 2.
+class StrategyTable {
+public:
+    // Widths up to this are tabulated at compile time with the full
+    // O(w^2) search, which also proves the balanced split optimal there.
+    static constexpr int compileTimeMax = 64;
+
+    // Extends the table to windows of up to `maxNumber` values in O(n).
+    void build(int maxNumber);
+    int maxNumber() const;
+
+    // Expected tries to hit a uniform target in [lowerBound, upperBound].
+    double expectedTries(int lowerBound, int upperBound) const;
+    int bestGuess(int lowerBound, int upperBound) const;
+
+private:
+    uint32_t total(int width) const;
+
+    // Sum of tries over every target of a width-w window, for w above
+    // compileTimeMax.
+    std::vector<uint32_t> totals;
+};
@@ -0,0 +1,59 @@
+#include "text_cache.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include "utf8.h"
+
+void TextLabel::assign(const char* value) {
+    if (built && std::strncmp(text, value, capacity - 1) == 0) {
+        return;
+    }
+    std::snprintf(text, capacity, "%s", value);
+    builtKey = 0;
+    built = true;
+    measured = false;
+    codepoints = static_cast<int>(utf8Count(text));
+}
+
+void TextLabel::format(uint64_t key, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(text, capacity, fmt, args);
+    va_end(args);
+    builtKey = key;
+    built = true;
+    measured = false;
+    codepoints = static_cast<int>(utf8Count(text));
+}
+
+bool TextLabel::needsMeasure(float fontSize, float spacing) const {
+    return !measured || fontSize != measuredFontSize || spacing != measuredSpacing;
+}
+
+void TextLabel::setMeasured(float fontSize, float spacing, float measuredWidth, float measuredHeight) {
+    measured = true;
+    measuredFontSize = fontSize;
+    measuredSpacing = spacing;
+    size[0] = measuredWidth;
+    size[1] = measuredHeight;
+}
+
+float TextLabel::scaledWidth(float scale) const {
+    float gaps = codepoints > 0 ? (codepoints - 1) * measuredSpacing : 0.0f;
+    return (size[0] - gaps) * scale + gaps;
+}
+
+uint64_t labelKey(uint64_t seed, uint64_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+uint64_t labelKey(uint64_t seed, const char* text, size_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 1099511628211ull;
+    }
+    return labelKey(seed, hash);
+}
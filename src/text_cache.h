@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A label that keeps its text in a fixed buffer together with the last
+// measured size. Text is rebuilt only when the caller's key changes and
+// re-measured only when the text, font size or spacing changes, so a frame
+// that draws unchanged labels does no formatting, measuring or allocation.
+class TextLabel {
+public:
+    static constexpr size_t capacity = 192;
+
+    const char* c_str() const { return text; }
+    float width() const { return size[0]; }
+    float height() const { return size[1]; }
+
+    // True when `key` differs from the key of the current text.
+    bool stale(uint64_t key) const { return !built || key != builtKey; }
+    void assign(const char* value);
+    void format(uint64_t key, const char* fmt, ...);
+
+    bool needsMeasure(float fontSize, float spacing) const;
+    void setMeasured(float fontSize, float spacing, float width, float height);
+
+    // Width at fontSize * scale derived from the last measurement, for
+    // labels whose size is animated every frame.
+    float scaledWidth(float scale) const;
+
+private:
+    char text[capacity] = "";
+    uint64_t builtKey = 0;
+    bool built = false;
+    bool measured = false;
+    float measuredFontSize = 0.0f;
+    float measuredSpacing = 0.0f;
+    float size[2] = {0.0f, 0.0f};
+    int codepoints = 0;
+};
+
+uint64_t labelKey(uint64_t seed, uint64_t value);
+uint64_t labelKey(uint64_t seed, const char* text, size_t length);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Minimal UTF-8 helpers for player names and label text.
+
+// Writes `codepoint` to `out` (room for 4 bytes) and returns the byte
+// count, or 0 for surrogates and values past U+10FFFF.
+inline int utf8Encode(int codepoint, char* out) {
+    if (codepoint < 0) {
+        return 0;
+    }
+    if (codepoint < 0x80) {
+        out[0] = static_cast<char>(codepoint);
+        return 1;
+    }
+    if (codepoint < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+        out[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 2;
+    }
+    if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
+        return 0;
+    }
+    if (codepoint < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+        out[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+    if (codepoint <= 0x10FFFF) {
+        out[0] = static_cast<char>(0xF0 | (codepoint >> 18));
+        out[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 4;
+    }
+    return 0;
+}
+
+// Decodes the codepoint at `text` (which must not be at its terminator)
+// and returns how many bytes it used. Malformed input yields U+FFFD for
+// one byte so callers always make progress.
+inline int utf8Decode(const char* text, int& codepoint) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(text);
+    int length = s[0] < 0x80 ? 1 : (s[0] >> 5) == 0x6 ? 2 : (s[0] >> 4) == 0xE ? 3 : (s[0] >> 3) == 0x1E ? 4 : 0;
+    if (length == 1) {
+        codepoint = s[0];
+        return 1;
+    }
+    int value = length == 2 ? s[0] & 0x1F : length == 3 ? s[0] & 0x0F : s[0] & 0x07;
+    for (int i = 1; i < length; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            length = 0;
+            break;
+        }
+        value = (value << 6) | (s[i] & 0x3F);
+    }
+    if (length == 0) {
+        codepoint = 0xFFFD;
+        return 1;
+    }
+    codepoint = value;
+    return length;
+}
+
+inline size_t utf8Count(const char* text) {
+    size_t count = 0;
+    for (const unsigned char* c = reinterpret_cast<const unsigned char*>(text); *c != 0; c++) {
+        if ((*c & 0xC0) != 0x80) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Removes the last codepoint, not just its last byte.
+inline void utf8PopBack(std::string& text) {
+    while (!text.empty()) {
+        unsigned char last = static_cast<unsigned char>(text.back());
+        text.pop_back();
+        if ((last & 0xC0) != 0x80) {
+            break;
+        }
+    }
+}